@@ -3,123 +3,312 @@
 // 
 
 #include "MAXgfx.h"
+#include "MAXgfx_Bitboard.h"
+#include "MAXgfx_Profile.h"
+#include "MAXgfx_Shapes.h"
+#include "MAXgfx_SpatialIndex.h"
 
 // unnamed namespace for static functions
 namespace
 {
+	//MAX72XX register addresses
+	const uint8_t REG_DIGIT_0 = 0x01;
+	const uint8_t REG_DECODE_MODE = 0x09;
+	const uint8_t REG_INTENSITY = 0x0A;
+	const uint8_t REG_SCAN_LIMIT = 0x0B;
+	const uint8_t REG_SHUTDOWN = 0x0C;
+	const uint8_t REG_DISPLAY_TEST = 0x0F;
+
 	//function prototypes
+#if !MAXGFX_USE_BITBOARD
 	void ClearMatrix(uint8_t* input, bool invert = false);
+#endif
+	void ClearBuffer(uint8_t* input, uint16_t length);
 	void OrMatrix(uint8_t* input1_result, const uint8_t* input2);
 	void TransposeMatrix(uint8_t* input, int move_x, int move_y);
 	void CopyMatrix(const uint8_t* input, uint8_t* output);
 	bool MaskMatrix(uint8_t* input, uint8_t size_x, uint8_t size_y);
-	bool AreSpritesOverlapped(const MAXSprite* Sprite1, const MAXSprite* Sprite2);
+	void TransformMatrix(uint8_t* input, uint8_t& size_x, uint8_t& size_y, uint8_t transform);
+	uint8_t TransformRow(const uint8_t* block, uint16_t stride, uint8_t row, uint8_t transform);
+	uint8_t ReverseBits(uint8_t bits);
+	bool OverlapSprites(MAXSprite& sprite1, MAXSprite& sprite2, uint8_t* result = NULL);
+	void DetectEdges(int x, int y, int width, int height, int bounds_width, int bounds_height, uint8_t& on, uint8_t& over, uint8_t& out);
+	uint8_t ResolveAxis(int& moved, int8_t& velocity, int size, int bounds, uint8_t policy, uint8_t low_edge, uint8_t high_edge);
 
 	//function definitions
+#if !MAXGFX_USE_BITBOARD
 	void ClearMatrix(uint8_t* input, bool invert)
 	{
-		//clear all values (or set all if invert is set
-		for (uint8_t i = 0; i < MATRIX_DIM; i++)
-			if (invert)
-				*(input + i) = 0xFF;
-			else
-				*(input + i) = 0x00;
+		//clear all values (or set all if invert is set)
+		memset(input, invert ? 0xFF : 0x00, MATRIX_DIM);
 	}
+#endif
+
+	void ClearBuffer(uint8_t* input, uint16_t length)
+	{
+		//multi-module framebuffers: libc memset works in full machine words
+		memset(input, 0x00, length);
+	}
+
+	void CopyMatrix(const uint8_t* input, uint8_t* output)
+	{
+		memcpy(output, input, MATRIX_DIM);
+	}
+
+#if MAXGFX_USE_BITBOARD
 
 	void OrMatrix(uint8_t* input1_result, const uint8_t* input2)
 	{
-		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+		MAXBitboard::store(MAXBitboard::load(input1_result) | MAXBitboard::load(input2), input1_result);
+	}
+
+	void TransposeMatrix(uint8_t* input, int move_x, int move_y)
+	{
+		MAXBitboard::store(MAXBitboard::shift(MAXBitboard::load(input), move_x, move_y), input);
+	}
+
+	bool MaskMatrix(uint8_t* input, uint8_t size_x, uint8_t size_y)
+	{
+		//mask (clear) all outside defined dimensions
+		MAXBitboard::store(MAXBitboard::load(input) & MAXBitboard::rectMask(size_x, size_y), input);
+		return true;
+	}
+
+	void TransformMatrix(uint8_t* input, uint8_t& size_x, uint8_t& size_y, uint8_t transform)
+	{
+		MAXBitboard::Board board = MAXBitboard::load(input);
+
+		//transpose keeps the top left corner in place, width and height swap
+		if (transform & TransformTranspose)
 		{
-			*(input1_result + i) |= *(input2 + i);
+			board = MAXBitboard::transpose(board);
+			uint8_t swap = size_x;
+			size_x = size_y;
+			size_y = swap;
 		}
 
+		//mirror the whole matrix, then move the sprite back to the top left corner
+		if (transform & TransformFlipH)
+			board = MAXBitboard::shiftLeft(MAXBitboard::flipHorizontal(board), MATRIX_DIM - size_x);
+		if (transform & TransformFlipV)
+			board = MAXBitboard::shiftUp(MAXBitboard::flipVertical(board), MATRIX_DIM - size_y);
+
+		MAXBitboard::store(board, input);
 	}
 
-	void TransposeMatrix(uint8_t* input, int move_x, int move_y)
+#else
+
+	void OrMatrix(uint8_t* input1_result, const uint8_t* input2)
 	{
-		//transpose x
 		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			*(input1_result + i) |= *(input2 + i);
+	}
+
+	void TransposeMatrix(uint8_t* input, int move_x, int move_y)
+	{
+		//anything moved a full matrix away is gone
+		if (abs(move_x) >= MATRIX_DIM || abs(move_y) >= MATRIX_DIM)
 		{
-			if (abs(move_x) >= MATRIX_DIM)
-				input[i] = 0x00;
-			else
-			{
-				if (move_x > 0)
-					*(input + i) >>= move_x;
-				else if (move_x < 0)
-					*(input + i) <<= abs(move_x);
-			}
+			ClearMatrix(input);
+			return;
 		}
 
-		//transpose y
-		if (move_y)
+		//transpose x
+		if (move_x > 0)
+			for (uint8_t i = 0; i < MATRIX_DIM; i++)
+				*(input + i) >>= move_x;
+		else if (move_x < 0)
+			for (uint8_t i = 0; i < MATRIX_DIM; i++)
+				*(input + i) <<= -move_x;
+
+		//transpose y (in place, copy in the direction of travel so rows aren't overwritten before they're read)
+		if (move_y > 0)
 		{
-			//temporary storage for transposed matrix
-			uint8_t temp[8];
+			for (int8_t i = MATRIX_DIM - 1; i >= move_y; i--)
+				*(input + i) = *(input + i - move_y);
+			memset(input, 0x00, move_y);
+		}
+		else if (move_y < 0)
+		{
+			for (uint8_t i = 0; i < MATRIX_DIM + move_y; i++)
+				*(input + i) = *(input + i - move_y);
+			memset(input + MATRIX_DIM + move_y, 0x00, -move_y);
+		}
+	}
 
-			for (uint8_t i = 0; i < MATRIX_DIM; i++)
+	bool MaskMatrix(uint8_t* input, uint8_t size_x, uint8_t size_y)
+	{
+		uint8_t mask = size_x >= MATRIX_DIM ? 0xFF : (uint8_t)(0xFF << (MATRIX_DIM - size_x));
+		if (size_y > MATRIX_DIM) size_y = MATRIX_DIM;
+
+		//mask (clear) all outside defined dimensions
+		for (uint8_t i = 0; i < size_y; i++)
+			*(input + i) &= mask;
+		memset(input + size_y, 0x00, MATRIX_DIM - size_y);
+
+		return true;
+	}
+
+	void TransformMatrix(uint8_t* input, uint8_t& size_x, uint8_t& size_y, uint8_t transform)
+	{
+		//transpose by swapping 4x4, then 2x2, then 1x1 blocks across the diagonal
+		if (transform & TransformTranspose)
+		{
+			uint8_t mask = 0x0F;
+			for (uint8_t j = 4; j; j >>= 1, mask ^= mask << j)
 			{
-				if (abs(move_y) >= MATRIX_DIM)
-					temp[i] = 0x00;
-				else
+				for (uint8_t k = 0; k < MATRIX_DIM; k = (k + j + 1) & ~j)
 				{
-					if (i - move_y >= 0 && i - move_y < MATRIX_DIM)
-					{
-						*(temp + i) = *(input + i - move_y);
-					}
-					else *(temp + i) = 0x00;
+					uint8_t t = (input[k] ^ (input[k + j] >> j)) & mask;
+					input[k] ^= t;
+					input[k + j] ^= t << j;
 				}
 			}
 
-			CopyMatrix(temp, input);
+			uint8_t swap = size_x;
+			size_x = size_y;
+			size_y = swap;
+		}
+
+		if (transform & TransformFlipH)
+		{
+			for (uint8_t i = 0; i < size_y; i++)
+				input[i] = ReverseBits(input[i]) << (MATRIX_DIM - size_x);
+		}
+
+		if (transform & TransformFlipV)
+		{
+			for (uint8_t i = 0; i < size_y / 2; i++)
+			{
+				uint8_t swap = input[i];
+				input[i] = input[size_y - 1 - i];
+				input[size_y - 1 - i] = swap;
+			}
 		}
 	}
 
-	void CopyMatrix(const uint8_t* input, uint8_t* output)
+#endif
+
+	uint8_t ReverseBits(uint8_t bits)
 	{
-		for (uint8_t i = 0; i < MATRIX_DIM; i++)
-			*(output + i) = *(input + i);
+		bits = (bits >> 4) | (bits << 4);
+		bits = ((bits >> 2) & 0x33) | ((bits & 0x33) << 2);
+		return ((bits >> 1) & 0x55) | ((bits & 0x55) << 1);
 	}
 
-	bool MaskMatrix(uint8_t* input, uint8_t size_x, uint8_t size_y)
+	uint8_t TransformRow(const uint8_t* block, uint16_t stride, uint8_t row, uint8_t transform)
 	{
-		//check for valid mask values
-		if (size_x >= MATRIX_DIM || size_y >= MATRIX_DIM)
-			return false;
+		//row of the transformed block is a row (or a column if transposed) of the block, counted from the bottom if flipped
+		if (transform & TransformFlipV)
+			row = MATRIX_DIM - 1 - row;
 
-		//mask (clear) all outside defined dimensions
-		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+		uint8_t bits = 0x00;
+		if (transform & TransformTranspose)
 		{
-			if (i < size_y)
-			{
-				uint8_t mask = 0xFF << (MATRIX_DIM - size_x);
-				*(input + i) &= mask;
-			}
-			else
-				*(input + i) = 0x00;
+			uint8_t column = 0x80 >> row;
+			for (uint8_t i = 0; i < MATRIX_DIM; i++, block += stride)
+				if (*block & column)
+					bits |= 0x80 >> i;
 		}
+		else
+			bits = block[row * stride];
+
+		return (transform & TransformFlipH) ? ReverseBits(bits) : bits;
 	}
 
-	bool AreSpritesOverlapped(MAXSprite* Sprite1, MAXSprite* Sprite2, uint8_t* result = NULL)
+#if MAXGFX_USE_BITBOARD
+	MAXBitboard::Board LoadSprite(MAXSprite& sprite)
 	{
-		bool found_overlap = false;
-		
-		uint8_t sprite1_data[8];
-		uint8_t sprite2_data[8];
+		//copied sprite data is stored masked, external data has to be read (and masked) row by row
+		if (sprite.hasSpriteData())
+			return MAXBitboard::load(sprite.getSpriteData());
 
-		CopyMatrix(Sprite1->getDisplayData(), sprite1_data);
-		CopyMatrix(Sprite2->getDisplayData(), sprite2_data);
+		uint8_t rows[MATRIX_DIM];
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			rows[i] = sprite.getSpriteRow(i);
+		return MAXBitboard::load(rows);
+	}
+#endif
+
+	bool OverlapSprites(MAXSprite& sprite1, MAXSprite& sprite2, uint8_t* result)
+	{
+		//sprite2 position relative to sprite1
+		int offset_x = sprite2.getPositionX() - sprite1.getPositionX();
+		int offset_y = sprite2.getPositionY() - sprite1.getPositionY();
 
+		//bounding boxes don't intersect
+		if (offset_x >= sprite1.getWidth() || -offset_x >= sprite2.getWidth() || offset_y >= sprite1.getHeight() || -offset_y >= sprite2.getHeight())
+			return false;
+
+		//AND sprite1 with sprite2 moved into sprite1's coordinates (sprite data is stored masked to size)
+#if MAXGFX_USE_BITBOARD
+		MAXBitboard::Board overlap = LoadSprite(sprite1) & MAXBitboard::shift(LoadSprite(sprite2), offset_x, offset_y);
+		if (result) MAXBitboard::store(overlap, result);
+		return overlap != 0;
+#else
+		uint8_t found_overlap = 0;
 		for (uint8_t i = 0; i < MATRIX_DIM; i++)
 		{
-			uint8_t row_result = (sprite1_data[i] & sprite2_data[i]);
-			if (row_result) found_overlap = true;
-			
+			uint8_t row2 = sprite2.getSpriteRow(i - offset_y);
+			uint8_t row_result = sprite1.getSpriteRow(i) & (offset_x > 0 ? row2 >> offset_x : row2 << -offset_x);
+			found_overlap |= row_result;
+
 			//return overlapped areas if result is non-null
 			if (result) result[i] = row_result;
 		}
 
 		return found_overlap;
+#endif
+	}
+
+	void DetectEdges(int x, int y, int width, int height, int bounds_width, int bounds_height, uint8_t& on, uint8_t& over, uint8_t& out)
+	{
+		//each edge bit from a compare, no branches
+		on = (y == 0) * MAXSprite::TopEdge | (y + height == bounds_height) * MAXSprite::BottomEdge |
+			(x == 0) * MAXSprite::LeftEdge | (x + width == bounds_width) * MAXSprite::RightEdge;
+		over = (y < 0) * MAXSprite::TopEdge | (y + height > bounds_height) * MAXSprite::BottomEdge |
+			(x < 0) * MAXSprite::LeftEdge | (x + width > bounds_width) * MAXSprite::RightEdge;
+		out = (y + height <= 0) * MAXSprite::TopEdge | (y >= bounds_height) * MAXSprite::BottomEdge |
+			(x + width <= 0) * MAXSprite::LeftEdge | (x >= bounds_width) * MAXSprite::RightEdge;
+	}
+
+	uint8_t ResolveAxis(int& moved, int8_t& velocity, int size, int bounds, uint8_t policy, uint8_t low_edge, uint8_t high_edge)
+	{
+		//one axis of a position already moved by velocity. low_edge/high_edge are the edge bits when that edge is
+		//constrained, 0 otherwise. Returns the edges hit
+		int max = bounds - size;
+
+		if (policy == MAXSprite::EdgeWrap)
+		{
+			//wrap through bounds + size positions, so the sprite is fully out for one step either way
+			uint8_t hit = (moved < -size ? low_edge : 0) | (moved >= bounds ? high_edge : 0);
+			int period = bounds + size;
+			if (hit && period > 0)
+			{
+				moved = (moved + size) % period;
+				moved = (moved < 0 ? moved + period : moved) - size;
+			}
+
+			return hit;
+		}
+
+		uint8_t hit_low = moved < 0 ? low_edge : 0;
+		uint8_t hit_high = moved > max ? high_edge : 0;
+
+		if (policy == MAXSprite::EdgeBounce)
+		{
+			//reflect position, velocity turns away from the edge hit
+			moved = hit_low ? -moved : moved;
+			moved = hit_high ? 2 * max - moved : moved;
+			int speed = velocity < 0 ? -velocity : velocity;
+			velocity = hit_low ? speed : (hit_high ? -speed : velocity);
+		}
+
+		//stop, or a bounce bigger than the space between the edges: same order as setConstrainedPosition
+		moved = (low_edge && moved < 0) ? 0 : moved;
+		moved = (high_edge && moved > max) ? max : moved;
+
+		return hit_low | hit_high;
 	}
 }
 
@@ -132,45 +321,39 @@ void MAXSprite::setConstrainedPosition(int position_x, int position_y, uint8_t p
 	
 	//constrain if required
 	if (position_constraints & TopEdge)
-		PositionX = (position_x < 0) ? 0 : position_x;
+		PositionY = (PositionY < 0) ? 0 : PositionY;
 	if (position_constraints & BottomEdge)
-		PositionX = (position_x > MATRIX_DIM - Height) ? MATRIX_DIM - Height : position_x;
+		PositionY = (PositionY > BoundsHeight - Height) ? BoundsHeight - Height : PositionY;
 	if (position_constraints & LeftEdge)
-		PositionY = (position_y < 0) ? 0 : position_y;
+		PositionX = (PositionX < 0) ? 0 : PositionX;
 	if (position_constraints & RightEdge)
-		PositionY = (position_y > MATRIX_DIM - Width) ? MATRIX_DIM - Width : position_y;
+		PositionX = (PositionX > BoundsWidth - Width) ? BoundsWidth - Width : PositionX;
 }
 
 void MAXSprite::detectEdges()
 {
-	//OnEdge
-	OnEdgeDectionResults = 0;
-	if (PositionY == 0) OnEdgeDectionResults |= TopEdge;
-	if (PositionY + Height == MATRIX_DIM) OnEdgeDectionResults |= BottomEdge;
-	if (PositionX == 0) OnEdgeDectionResults |= LeftEdge;
-	if (PositionX + Width == MATRIX_DIM) OnEdgeDectionResults |= RightEdge;
-
-	//OverEdge
-	OverEdgeDetectionResults = 0;
-	if (PositionY < 0) OverEdgeDetectionResults |= TopEdge;
-	if (PositionY + Height > MATRIX_DIM) OverEdgeDetectionResults |= BottomEdge; 
-	if (PositionX < 0) OverEdgeDetectionResults |= LeftEdge;
-	if (PositionX + Width > MATRIX_DIM) OverEdgeDetectionResults |= RightEdge;
-	
-	//OutofBounds
-	OutOfBoundsDetectionResults = 0; 
-	if (PositionY + Height <= 0) OutOfBoundsDetectionResults |= TopEdge;
-	if (PositionY >= MATRIX_DIM) OutOfBoundsDetectionResults |= BottomEdge;
-	if (PositionX + Width <= 0) OutOfBoundsDetectionResults |= LeftEdge;
-	if (PositionX >= MATRIX_DIM) OutOfBoundsDetectionResults |= RightEdge;
+	DetectEdges(PositionX, PositionY, Width, Height, BoundsWidth, BoundsHeight, OnEdgeDectionResults, OverEdgeDetectionResults, OutOfBoundsDetectionResults);
 }
 
 void MAXSprite::updateDisplayData()
 {
-	ClearMatrix(DisplayData);
-	CopyMatrix(SpriteData, DisplayData);
-	MaskMatrix(DisplayData, Width, Height);
+	//cached render still valid
+	if (!DisplayDataDirty)
+		return;
+
+	MAXGFX_PROFILE_SCOPE(ProfileRender);
+	MAXGFX_PROFILE_COUNT(Renders, 1);
+
+	//copied sprite data is already masked to sprite size, external data is masked as it's read
+	if (hasSpriteData())
+		CopyMatrix(SpriteData, DisplayData);
+	else
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			DisplayData[i] = getSpriteRow(i);
+
 	TransposeMatrix(DisplayData, PositionX, PositionY);
+
+	DisplayDataDirty = false;
 }
 
 uint8_t MAXSprite::isTouchingSprite(MAXSprite& other)
@@ -221,18 +404,78 @@ MAXSprite::MAXSprite(const uint8_t* data, uint8_t width, uint8_t height, int pos
 	initSprite(data, width, height, position_x, position_y, position_constraints, show);
 }
 
+MAXSprite& MAXSprite::operator=(const MAXSprite& other)
+{
+	if (this == &other)
+		return *this;
+
+	//everything but the index membership
+	CopyMatrix(other.SpriteData, SpriteData);
+	Source = other.Source;
+	SourceProgmem = other.SourceProgmem;
+	Transform = other.Transform;
+	Width = other.Width;
+	Height = other.Height;
+	CopyMatrix(other.DisplayData, DisplayData);
+	DisplayDataDirty = other.DisplayDataDirty;
+	PositionX = other.PositionX;
+	PositionY = other.PositionY;
+	PositionConstraints = other.PositionConstraints;
+	BoundsWidth = other.BoundsWidth;
+	BoundsHeight = other.BoundsHeight;
+	VelocityX = other.VelocityX;
+	VelocityY = other.VelocityY;
+	EdgePolicy = other.EdgePolicy;
+	Show = other.Show;
+	OnEdgeDectionResults = other.OnEdgeDectionResults;
+	OverEdgeDetectionResults = other.OverEdgeDetectionResults;
+	OutOfBoundsDetectionResults = other.OutOfBoundsDetectionResults;
+
+	//own entry (if any) follows the new position and size
+	if (Index)
+		Index->updateSprite(*this);
+
+	return *this;
+}
+
 void MAXSprite::initSprite(const uint8_t* data, uint8_t width, uint8_t height, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
 {
 	//copy data to internal storage
 	CopyMatrix(data, SpriteData);
+	Source = NULL;
 
+	initProperties(width, height, position_x, position_y, position_constraints, show);
+}
+
+void MAXSprite::initSprite_P(const uint8_t* data, uint8_t width, uint8_t height, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
+{
+	//read data from flash when rendering, nothing copied
+	setSource(data, true);
+
+	initProperties(width, height, position_x, position_y, position_constraints, show);
+}
+
+void MAXSprite::initProperties(uint8_t width, uint8_t height, int position_x, int position_y, uint8_t position_constraints, bool show)
+{
 	//constrain dimensions to size of matrix
 	Width = ConstrainToMatrixDimensions(width);
 	Height = ConstrainToMatrixDimensions(height);
 
+	//clear anything outside sprite size once, rather than on every render, then orient
+	if (!Source)
+	{
+		MaskMatrix(SpriteData, Width, Height);
+		transformSpriteData(Transform);
+	}
+	else if (Transform)
+		cacheSource(Width, Height);
+
 	//set position 
 	PositionConstraints = position_constraints & 0x0F;
 
+	//sprite data and size have changed
+	invalidateDisplayData();
+
 	//set position with new values
 	setPosition(position_x, position_y);
 	
@@ -240,13 +483,80 @@ void MAXSprite::initSprite(const uint8_t* data, uint8_t width, uint8_t height, i
 	Show = show;
 }
 
+void MAXSprite::setSource(const uint8_t* data, bool progmem /*= false*/)
+{
+	//untransformed size of the current data
+	uint8_t width = (Transform & TransformTranspose) ? Height : Width;
+	uint8_t height = (Transform & TransformTranspose) ? Width : Height;
+
+	Source = data;
+	SourceProgmem = progmem;
+
+	//new data, transform it once here rather than on every read
+	if (Transform)
+		cacheSource(width, height);
+
+	invalidateDisplayData();
+}
+
+void MAXSprite::transformSpriteData(uint8_t transform)
+{
+	if (transform)
+		TransformMatrix(SpriteData, Width, Height, transform);
+}
+
+void MAXSprite::cacheSource(uint8_t width, uint8_t height)
+{
+	Width = width;
+	Height = height;
+
+	for (uint8_t i = 0; i < MATRIX_DIM; i++)
+		SpriteData[i] = readSourceRow(i);
+	MaskMatrix(SpriteData, Width, Height);
+
+	transformSpriteData(Transform);
+}
+
+void MAXSprite::setTransform(uint8_t transform)
+{
+	transform &= TransformAntiTranspose;
+	if (transform == Transform)
+		return;
+
+	if (Source)
+	{
+		//transform again from the external data (or read it in place again if no transform is left)
+		uint8_t width = (Transform & TransformTranspose) ? Height : Width;
+		uint8_t height = (Transform & TransformTranspose) ? Width : Height;
+
+		Transform = transform;
+		cacheSource(width, height);
+	}
+	else
+	{
+		//copied data: undo the current orientation and apply the new one in one step
+		transformSpriteData(MAXComposeTransform(MAXInverseTransform(Transform), transform));
+		Transform = transform;
+	}
+
+	//size may have changed, apply constraints and edge detection again
+	setPosition(PositionX, PositionY);
+}
+
 void MAXSprite::setPosition(int position_x, int position_y)
 {
 	//set position using configured constraints
 	setConstrainedPosition(position_x, position_y, PositionConstraints);
 
+	//position has changed, render again on next read
+	invalidateDisplayData();
+
 	//position has changed, update edge detection values
 	detectEdges();
+
+	//and the spatial index
+	if (Index)
+		Index->updateSprite(*this);
 }
 
 void MAXSprite::move(int distance_x, int distance_y)
@@ -259,6 +569,15 @@ void MAXSprite::setPositionConstraints(uint8_t constraints)
 	PositionConstraints = constraints & 0xF;
 }
 
+void MAXSprite::setBounds(int width, int height)
+{
+	BoundsWidth = width;
+	BoundsHeight = height;
+
+	//re-apply constraints and edge detection against new bounds
+	setPosition(PositionX, PositionY);
+}
+
 const uint8_t* MAXSprite::getDisplayData()
 {
 	updateDisplayData();
@@ -267,128 +586,642 @@ const uint8_t* MAXSprite::getDisplayData()
 
 uint8_t MAXSprite::getDisplayRow(uint8_t row)
 {
+	if (row >= MATRIX_DIM)
+		return 0x00;
+
 	updateDisplayData();
+	return DisplayData[row];
+}
 
-	if (row < MATRIX_DIM)
-		return DisplayData[row];
-	else
-		return 0x00;
+MAXgfx_Base::MAXgfx_Base(MAXDriver& driver, uint8_t module_cols, uint8_t module_rows, uint8_t* display_data, uint8_t* sent_data, MAXLayer* layers, uint8_t layer_capacity) :
+	MAX(driver), ModuleCols(module_cols), ModuleRows(module_rows), Layers(layers), LayerCapacity(layer_capacity),
+	FrameBuffer(display_data, module_cols * MATRIX_DIM, module_rows * MATRIX_DIM), DisplayData(display_data), SentData(sent_data)
+{
+	//all layers start on the free list (linked through Above)
+	for (uint8_t i = 0; i < LayerCapacity; i++)
+	{
+		Layers[i].Sprite = NULL;
+		Layers[i].Drawable = NULL;
+		Layers[i].Above = (i + 1 < LayerCapacity) ? i + 1 : LAYER_NONE;
+	}
+	FreeLayer = LayerCapacity ? 0 : LAYER_NONE;
+}
+
+void MAXgfx_Base::init()
+{
+	MAX.begin(ModuleCols * ModuleRows);
+
+	writeRegisterAll(REG_DISPLAY_TEST, TestMode ? 0x01 : 0x00);
+	writeRegisterAll(REG_DECODE_MODE, 0x00);
+	writeRegisterAll(REG_SCAN_LIMIT, MATRIX_DIM - 1);
+	writeRegisterAll(REG_INTENSITY, Intensity);
+	writeRegisterAll(REG_SHUTDOWN, ShutDown ? 0x00 : 0x01);
+
+	//device contents unknown, next refresh sends everything
+	invalidateDisplay();
+}
+
+void MAXgfx_Base::setIntensity(uint8_t intensity)
+{
+	Intensity = intensity & 0x0F;
+	writeRegisterAll(REG_INTENSITY, Intensity);
+}
+
+void MAXgfx_Base::setShutDownMode(bool shutdown)
+{
+	ShutDown = shutdown;
+	writeRegisterAll(REG_SHUTDOWN, shutdown ? 0x00 : 0x01);
+}
+
+void MAXgfx_Base::setTestMode(bool test_mode)
+{
+	TestMode = test_mode;
+	writeRegisterAll(REG_DISPLAY_TEST, test_mode ? 0x01 : 0x00);
 }
 
-bool MAXgfx::addSprite(MAXSprite& sprite)
+void MAXgfx_Base::writeRegisterAll(uint8_t reg, uint8_t data)
 {
-	for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+	MAXGFX_PROFILE_SCOPE(ProfileBus);
+	MAXGFX_PROFILE_COUNT(BusBytes, ModuleCols * ModuleRows * 2);
+
+	MAX.beginWrite();
+	for (uint8_t i = 0; i < ModuleCols * ModuleRows; i++)
+		MAX.write(reg, data);
+	MAX.endWrite();
+}
+
+void MAXgfx_Base::writeDigitRow(uint8_t digit)
+{
+	MAXGFX_PROFILE_SCOPE(ProfileBus);
+	MAXGFX_PROFILE_COUNT(BusBytes, ModuleCols * ModuleRows * 2);
+
+	//data for the last device in the chain is shifted out first
+	MAX.beginWrite();
+	for (int8_t module_row = ModuleRows - 1; module_row >= 0; module_row--)
 	{
-		//find first open (null) slot and store sprite
-		if (!Sprites[i])
+		uint8_t* row_data = DisplayData + (module_row * MATRIX_DIM + digit) * ModuleCols;
+		uint8_t* sent_data = SentData + (row_data - DisplayData);
+
+		for (int8_t module_col = ModuleCols - 1; module_col >= 0; module_col--)
 		{
-			Sprites[i] = &sprite;
-			return true;
+			//digit registers are 0x01 - 0x08, one per row
+			uint8_t data = ModuleTransform ? getDeviceRow(module_col, module_row, digit) : row_data[module_col];
+			MAX.write(REG_DIGIT_0 + digit, data);
+			sent_data[module_col] = data;
 		}
 	}
-
-	//didn't find an open slot
-	return false;
+	MAX.endWrite();
 }
 
-bool MAXgfx::removeSprite(uint8_t location)
+uint8_t MAXgfx_Base::getTransformedRow(const uint8_t* block, uint8_t digit)
 {
-	//check for valid location
-	if (location >= SPRITE_LOCATION_CNT) return false;
+	return TransformRow(block, ModuleCols, digit, ModuleTransform);
+}
 
-	//clear location
-	Sprites[location] = NULL;
-	
-	//move all sprites to lower locations (fill the gap if it's there)
-	for (uint8_t i = location + 1; i < SPRITE_LOCATION_CNT; i++)
+bool MAXgfx_Base::isDigitRowChanged(uint8_t digit)
+{
+	for (uint8_t module_row = 0; module_row < ModuleRows; module_row++)
 	{
-		//check for filled (non-null) higher slots and move them down by one to fill gap
-		if (Sprites[i])
+		uint16_t index = (module_row * MATRIX_DIM + digit) * ModuleCols;
+
+		//untransformed rows compare straight from the framebuffer
+		if (!ModuleTransform)
+		{
+			if (memcmp(DisplayData + index, SentData + index, ModuleCols))
+				return true;
+			continue;
+		}
+
+		for (uint8_t module_col = 0; module_col < ModuleCols; module_col++)
 		{
-			Sprites[i - 1] = Sprites[i];
-			Sprites[i] = NULL;
+			if (getDeviceRow(module_col, module_row, digit) != SentData[index + module_col])
+				return true;
 		}
 	}
 
+	return false;
+}
+
+void MAXgfx_Base::blitSprite(MAXSprite& sprite, uint8_t blend)
+{
+	int display_width = getDisplayWidth();
+	int display_height = getDisplayHeight();
+	int x = sprite.getPositionX();
+
+	//entirely off display horizontally
+	if (x <= -MATRIX_DIM || x >= display_width)
+		return;
+
+	MAXGFX_PROFILE_SCOPE(ProfileBlit);
+	MAXGFX_PROFILE_COUNT(Blits, 1);
+
+	//first (possibly partial) framebuffer column and bit offset within it
+	int col = x < 0 ? -1 : x / MATRIX_DIM;
+	uint8_t shift = x - col * MATRIX_DIM;
+
+	//bounding box of a sprite row, used by opaque blending
+	uint8_t mask = sprite.getWidth() >= MATRIX_DIM ? 0xFF : (uint8_t)~(0xFF >> sprite.getWidth());
+
+	for (uint8_t i = 0; i < sprite.getHeight(); i++)
+	{
+		int y = sprite.getPositionY() + i;
+		if (y < 0)
+			continue;
+		if (y >= display_height)
+			break;
+
+		uint8_t bits = sprite.getSpriteRow(i);
+		uint8_t* row_data = FrameBuffer.getRow(y);
+
+		//sprite row straddles at most two framebuffer bytes
+		if (col >= 0)
+			MAXBlendByte(row_data + col, bits >> shift, mask >> shift, blend);
+		if (shift && col + 1 < ModuleCols)
+			MAXBlendByte(row_data + col + 1, bits << (MATRIX_DIM - shift), mask << (MATRIX_DIM - shift), blend);
+	}
+}
+
+uint8_t MAXgfx_Base::insertLayer(MAXSprite* sprite, MAXDrawable* drawable, uint8_t blend, uint8_t below, uint8_t above)
+{
+	//pool is full
+	if (FreeLayer == LAYER_NONE)
+		return LAYER_NONE;
+
+	//take first free layer
+	uint8_t layer = FreeLayer;
+	FreeLayer = Layers[layer].Above;
+
+	Layers[layer].Sprite = sprite;
+	Layers[layer].Drawable = drawable;
+	Layers[layer].Blend = blend;
+	linkLayer(layer, below, above);
+	LayerCount++;
+
+	//sprite moves over the whole display
+	if (sprite)
+		sprite->setBounds(getDisplayWidth(), getDisplayHeight());
+
+	return layer;
+}
+
+void MAXgfx_Base::linkLayer(uint8_t layer, uint8_t below, uint8_t above)
+{
+	Layers[layer].Below = below;
+	Layers[layer].Above = above;
+
+	if (below != LAYER_NONE) Layers[below].Above = layer;
+	else BottomLayer = layer;
+
+	if (above != LAYER_NONE) Layers[above].Below = layer;
+	else TopLayer = layer;
+}
+
+void MAXgfx_Base::unlinkLayer(uint8_t layer)
+{
+	uint8_t below = Layers[layer].Below;
+	uint8_t above = Layers[layer].Above;
+
+	if (below != LAYER_NONE) Layers[below].Above = above;
+	else BottomLayer = above;
+
+	if (above != LAYER_NONE) Layers[above].Below = below;
+	else TopLayer = below;
+}
+
+uint8_t MAXgfx_Base::addLayer(MAXSprite& sprite, uint8_t blend /*= BlendOr*/)
+{
+	return insertLayer(&sprite, NULL, blend, TopLayer, LAYER_NONE);
+}
+
+uint8_t MAXgfx_Base::addLayerAbove(uint8_t layer, MAXSprite& sprite, uint8_t blend /*= BlendOr*/)
+{
+	if (!isLayerUsed(layer)) return LAYER_NONE;
+
+	return insertLayer(&sprite, NULL, blend, layer, Layers[layer].Above);
+}
+
+uint8_t MAXgfx_Base::addLayerBelow(uint8_t layer, MAXSprite& sprite, uint8_t blend /*= BlendOr*/)
+{
+	if (!isLayerUsed(layer)) return LAYER_NONE;
+
+	return insertLayer(&sprite, NULL, blend, Layers[layer].Below, layer);
+}
+
+uint8_t MAXgfx_Base::addLayer(MAXDrawable& drawable, uint8_t blend /*= BlendOr*/)
+{
+	return insertLayer(NULL, &drawable, blend, TopLayer, LAYER_NONE);
+}
+
+uint8_t MAXgfx_Base::addLayerAbove(uint8_t layer, MAXDrawable& drawable, uint8_t blend /*= BlendOr*/)
+{
+	if (!isLayerUsed(layer)) return LAYER_NONE;
+
+	return insertLayer(NULL, &drawable, blend, layer, Layers[layer].Above);
+}
+
+uint8_t MAXgfx_Base::addLayerBelow(uint8_t layer, MAXDrawable& drawable, uint8_t blend /*= BlendOr*/)
+{
+	if (!isLayerUsed(layer)) return LAYER_NONE;
+
+	return insertLayer(NULL, &drawable, blend, Layers[layer].Below, layer);
+}
+
+bool MAXgfx_Base::removeLayer(uint8_t layer)
+{
+	if (!isLayerUsed(layer)) return false;
+
+	unlinkLayer(layer);
+
+	//return to free list
+	Layers[layer].Sprite = NULL;
+	Layers[layer].Drawable = NULL;
+	Layers[layer].Above = FreeLayer;
+	FreeLayer = layer;
+	LayerCount--;
+
 	return true;
 }
 
-bool MAXgfx::replaceSprite(uint8_t location, MAXSprite sprite)
+bool MAXgfx_Base::moveLayerToTop(uint8_t layer)
 {
+	if (!isLayerUsed(layer)) return false;
+
+	unlinkLayer(layer);
+	linkLayer(layer, TopLayer, LAYER_NONE);
+	return true;
+}
+
+bool MAXgfx_Base::moveLayerToBottom(uint8_t layer)
+{
+	if (!isLayerUsed(layer)) return false;
+
+	unlinkLayer(layer);
+	linkLayer(layer, LAYER_NONE, BottomLayer);
+	return true;
+}
+
+bool MAXgfx_Base::moveLayerAbove(uint8_t layer, uint8_t other)
+{
+	if (!isLayerUsed(layer) || !isLayerUsed(other) || layer == other) return false;
+
+	unlinkLayer(layer);
+	linkLayer(layer, other, Layers[other].Above);
+	return true;
+}
+
+bool MAXgfx_Base::moveLayerBelow(uint8_t layer, uint8_t other)
+{
+	if (!isLayerUsed(layer) || !isLayerUsed(other) || layer == other) return false;
+
+	unlinkLayer(layer);
+	linkLayer(layer, Layers[other].Below, other);
+	return true;
+}
+
+bool MAXgfx_Base::setLayerBlend(uint8_t layer, uint8_t blend)
+{
+	if (!isLayerUsed(layer)) return false;
+
+	Layers[layer].Blend = blend;
+	return true;
+}
+
+uint8_t MAXgfx_Base::getLayerAt(uint8_t location)
+{
+	//walk up from the bottom layer
+	uint8_t layer = BottomLayer;
+	while (location-- && layer != LAYER_NONE)
+		layer = Layers[layer].Above;
+
+	return layer;
+}
+
+bool MAXgfx_Base::replaceSprite(uint8_t location, MAXSprite& sprite)
+{
+	uint8_t layer = getLayerAt(location);
+
 	//check for valid location
-	if (location >= SPRITE_LOCATION_CNT) return false;
+	if (layer == LAYER_NONE) return false;
 
 	//replace sprite at given location
-	Sprites[location] = &sprite;
+	Layers[layer].Sprite = &sprite;
+	Layers[layer].Drawable = NULL;
+	sprite.setBounds(getDisplayWidth(), getDisplayHeight());
 
 	return true;
 }
 
-void MAXgfx::updateDisplay()
+MAXSprite* MAXgfx_Base::getSprite(uint8_t location)
 {
-	
+	return getLayerSprite(getLayerAt(location));
+}
+
+void MAXgfx_Base::getSpriteCopy(uint8_t location, MAXSprite* sprite)
+{
+	MAXSprite* source = getSprite(location);
+
+	//copy keeps its own index entry (if any), see MAXSprite::operator=
+	if (source && sprite)
+		*sprite = *source;
+}
+
+void MAXgfx_Base::setSpritePosition(uint8_t index, int position_x, int position_y)
+{
+	MAXSprite* sprite = getSprite(index);
+
+	if (sprite)
+		sprite->setPosition(position_x, position_y);
+}
+
+void MAXgfx_Base::moveSprite(uint8_t location, int distance_x, int distance_y)
+{
+	MAXSprite* sprite = getSprite(location);
+
+	if (sprite)
+		sprite->move(distance_x, distance_y);
+}
+
+uint8_t MAXgfx_Base::moveSprites(SpriteEdgeEvent* events /*= NULL*/, uint8_t max_events /*= 0*/)
+{
+	uint8_t found = 0;
+
+	for (uint8_t i = BottomLayer; i != LAYER_NONE; i = Layers[i].Above)
+	{
+		//still sprites keep their position and edge detection
+		MAXSprite* sprite = Layers[i].Sprite;
+		if (!sprite || (!sprite->VelocityX && !sprite->VelocityY))
+			continue;
+
+		int x = sprite->PositionX + sprite->VelocityX;
+		int y = sprite->PositionY + sprite->VelocityY;
+		int width = sprite->Width;
+		int height = sprite->Height;
+		uint8_t hit = 0, on = 0, over = 0, out = 0;
+
+		//most sprites are clear of every edge: nothing to resolve or detect. Otherwise apply the edge policy and detect
+		if (x <= 0 || x >= sprite->BoundsWidth - width || y <= 0 || y >= sprite->BoundsHeight - height)
+		{
+			uint8_t constraints = sprite->PositionConstraints;
+			hit = ResolveAxis(x, sprite->VelocityX, width, sprite->BoundsWidth, sprite->EdgePolicy,
+				constraints & MAXSprite::LeftEdge, constraints & MAXSprite::RightEdge);
+			hit |= ResolveAxis(y, sprite->VelocityY, height, sprite->BoundsHeight, sprite->EdgePolicy,
+				constraints & MAXSprite::TopEdge, constraints & MAXSprite::BottomEdge);
+
+			DetectEdges(x, y, width, height, sprite->BoundsWidth, sprite->BoundsHeight, on, over, out);
+		}
+
+		bool changed = on != sprite->OnEdgeDectionResults || over != sprite->OverEdgeDetectionResults || out != sprite->OutOfBoundsDetectionResults;
+
+		sprite->OnEdgeDectionResults = on;
+		sprite->OverEdgeDetectionResults = over;
+		sprite->OutOfBoundsDetectionResults = out;
+
+		if (x != sprite->PositionX || y != sprite->PositionY)
+		{
+			sprite->PositionX = x;
+			sprite->PositionY = y;
+			sprite->invalidateDisplayData();
+			if (sprite->Index)
+				sprite->Index->updateSprite(*sprite);
+		}
+
+		if ((hit || changed) && found < max_events)
+		{
+			events[found].Layer = i;
+			events[found].Hit = hit;
+			events[found].OnEdge = on;
+			events[found].OverEdge = over;
+			events[found].OutOfBounds = out;
+			found++;
+		}
+	}
+
+	return found;
+}
+
+bool MAXgfx_Base::isOverlapping(MAXSprite& sprite1, MAXSprite& sprite2, uint8_t* mask /*= NULL*/)
+{
+	return OverlapSprites(sprite1, sprite2, mask);
+}
+
+bool MAXgfx_Base::isOverlapping(uint8_t layer1, uint8_t layer2, uint8_t* mask /*= NULL*/)
+{
+	MAXSprite* sprite1 = getLayerSprite(layer1);
+	MAXSprite* sprite2 = getLayerSprite(layer2);
+
+	return sprite1 && sprite2 && OverlapSprites(*sprite1, *sprite2, mask);
+}
+
+uint8_t MAXgfx_Base::findCollisions(SpriteCollision* collisions, uint8_t max_collisions)
+{
+	uint8_t found = 0;
+
+	//test every pair of shown sprites once
+	for (uint8_t i = BottomLayer; i != LAYER_NONE; i = Layers[i].Above)
+	{
+		if (!Layers[i].Sprite || Layers[i].Sprite->isHidden())
+			continue;
+
+		for (uint8_t j = Layers[i].Above; j != LAYER_NONE && found < max_collisions; j = Layers[j].Above)
+		{
+			if (!Layers[j].Sprite || Layers[j].Sprite->isHidden())
+				continue;
+
+			if (OverlapSprites(*Layers[i].Sprite, *Layers[j].Sprite, collisions[found].Mask))
+			{
+				collisions[found].Layer1 = i;
+				collisions[found].Layer2 = j;
+				found++;
+			}
+		}
+	}
+
+	return found;
+}
+
+void MAXgfx_Base::updateDisplay()
+{
+	composite();
+	refresh();
+}
+
+void MAXgfx_Base::composite()
+{
+	MAXGFX_PROFILE_SCOPE(ProfileComposite);
+	MAXGFX_PROFILE_COUNT(Frames, 1);
+
+	//back buffer may just have been handed over by the refresh stage
+	MAXGFX_BARRIER();
+
 	//clear display data
-	ClearMatrix(DisplayData);
+	uint8_t* frame_data = FrameBuffer.getData();
+	ClearBuffer(frame_data, ModuleCols * ModuleRows * MATRIX_DIM);
 
-	//get all sprite data and OR together
-	for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+	//combine layers bottom to top
+	for (uint8_t i = BottomLayer; i != LAYER_NONE; i = Layers[i].Above)
 	{
-		//check for filled (non-null) sprites and or with result
-		if (Sprites[i])
+		//drawables render themselves
+		if (Layers[i].Drawable)
+		{
+			if (Layers[i].Drawable->isShown())
+				Layers[i].Drawable->draw(FrameBuffer, Layers[i].Blend);
+			continue;
+		}
+
+		//nothing to draw, hidden or entirely off the display
+		MAXSprite* sprite = Layers[i].Sprite;
+		if (sprite->isHidden() ||
+			sprite->getPositionX() <= -sprite->getWidth() || sprite->getPositionX() >= getDisplayWidth() ||
+			sprite->getPositionY() <= -sprite->getHeight() || sprite->getPositionY() >= getDisplayHeight())
 		{
-			if (Sprites[i]->isShown())
-				OrMatrix(DisplayData, Sprites[i]->getDisplayData());
+			MAXGFX_PROFILE_COUNT(SpritesSkipped, 1);
+			continue;
 		}
+
+		//single module: sprite's cached render is already in display coordinates
+		if (ModuleCols == 1 && ModuleRows == 1 && Layers[i].Blend == BlendOr)
+			OrMatrix(frame_data, sprite->getDisplayData());
+		else
+			blitSprite(*sprite, Layers[i].Blend);
 	}
+}
+
+void MAXgfx_Base::refresh()
+{
+	//blocking: finish a frame still being sent, then send this one (waits for a queued driver rather than skip rows)
+	while (!present())
+		refreshRows(MATRIX_DIM);
+	while (!refreshRows(MATRIX_DIM) || isFramePending());
+}
 
-	//send to MAX72XX
-	MAX.setMatrix(DisplayData);
+void MAXgfx_Base::setBackBuffer(uint8_t* back_data)
+{
+	BackData = back_data;
+	SwapPending = false;
 
+	//composite into the back buffer from now on (or the display buffer if back_data is NULL)
+	FrameBuffer = MAXBitmap(BackData ? BackData : DisplayData, ModuleCols * MATRIX_DIM, ModuleRows * MATRIX_DIM);
 }
 
-MAXSprite_MultiFrame::MAXSprite_MultiFrame(uint8_t** data, uint8_t frame_count, uint8_t width, uint8_t height, int position_x, int position_y, bool position_constraints, bool show)
+bool MAXgfx_Base::present()
 {
-	//initialize base sprite class
-	MAXSprite::initSprite((uint8_t*)data, width, height, position_x, position_y, position_constraints, show);
+	//single buffered, start sending the framebuffer
+	if (!BackData)
+	{
+		beginRefresh();
+		return true;
+	}
 
-	FrameCount = frame_count;
-	FrameData = (uint8_t*)data;
+	//refresh stage hasn't taken the previous frame yet
+	if (SwapPending)
+		return false;
+
+	//frame must be complete in memory before the consumer can see the flag
+	MAXGFX_BARRIER();
+	SwapPending = true;
+	return true;
 }
 
-bool MAXSprite_MultiFrame::loadFrame(uint8_t frame)
+void MAXgfx_Base::swapBuffers()
 {
-	if (frame >= FrameCount)
+	uint8_t* front = BackData;
+	BackData = DisplayData;
+	DisplayData = front;
+	FrameBuffer = MAXBitmap(BackData, ModuleCols * MATRIX_DIM, ModuleRows * MATRIX_DIM);
+
+	//buffers swapped before the producer may touch the new back buffer
+	MAXGFX_BARRIER();
+	SwapPending = false;
+}
+
+bool MAXgfx_Base::refreshRows(uint8_t max_rows)
+{
+	if (RefreshDigit >= MATRIX_DIM)
+	{
+		//idle, start on a presented frame if there is one
+		if (!BackData || !SwapPending)
+			return true;
+
+		swapBuffers();
+		RefreshDigit = 0;
+	}
+
+	if (MAX.isBusy())
 		return false;
 
-	//load frame data as base class sprite
-	CopyMatrix((FrameData + (frame * MATRIX_DIM)), SpriteData);
-	
-	//update current frame
-	CurrentFrame = frame;
+	MAXGFX_PROFILE_SCOPE(ProfileRefresh);
+
+	//send only digit rows that differ from what the devices already hold (everything on first frame after init)
+	for (; RefreshDigit < MATRIX_DIM; RefreshDigit++)
+	{
+		if (SentDataValid && !isDigitRowChanged(RefreshDigit))
+		{
+			RowsSkipped++;
+			MAXGFX_PROFILE_COUNT(RowsSkipped, 1);
+			continue;
+		}
 
+		//row budget used up, continue from here on next call
+		if (!max_rows)
+			return false;
+
+		writeDigitRow(RefreshDigit);
+		RowsWritten++;
+		MAXGFX_PROFILE_COUNT(RowsSent, 1);
+		max_rows--;
+	}
+
+	SentDataValid = true;
+	MAX.endFrame();
 	return true;
 }
 
-void MAXSprite_MultiFrame::nextFrame()
+void MAXSprite_Animated::nextFrame()
 {
+	if (!FrameCount)
+		return;
+
+	//wrap round to zero past the last frame, to the last frame below zero
 	if (reverse)
-		reverseFrame();
+		loadFrame(CurrentFrame > 0 ? CurrentFrame - 1 : FrameCount - 1);
 	else
-		forwardFrame();
+		loadFrame(CurrentFrame + 1 < FrameCount ? CurrentFrame + 1 : 0);
+}
+
+MAXSprite_MultiFrame::MAXSprite_MultiFrame(uint8_t** data, uint8_t frame_count, uint8_t width, uint8_t height, int position_x, int position_y, bool position_constraints, bool show)
+{
+	//frames are stored back to back in RAM
+	FrameCount = frame_count;
+	FrameData = (const uint8_t*)data;
+
+	//initialize base sprite class with first frame
+	setSource(FrameData);
+	initProperties(width, height, position_x, position_y, position_constraints, show);
 }
 
-void MAXSprite_MultiFrame::forwardFrame()
+MAXSprite_MultiFrame::MAXSprite_MultiFrame(const uint8_t* frames, uint8_t frame_count, uint8_t width, uint8_t height, bool progmem, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
 {
-	//increment Current Frame, wrap back round to zero at FrameCount
-	CurrentFrame = (CurrentFrame + 1) % FrameCount;
-	loadFrame(CurrentFrame);
+	FrameCount = frame_count;
+	FrameData = frames;
+	FrameProgmem = progmem;
+
+	//initialize base sprite class with first frame
+	setSource(FrameData, FrameProgmem);
+	initProperties(width, height, position_x, position_y, position_constraints, show);
 }
 
-void MAXSprite_MultiFrame::reverseFrame()
+bool MAXSprite_MultiFrame::loadFrame(uint16_t frame)
 {
-	//decrement Current Frame, wrap back round to FrameCount - 1 below zero
-	CurrentFrame = CurrentFrame > 0 ? CurrentFrame - 1 : FrameCount - 1;
-	loadFrame(CurrentFrame);
+	if (frame >= FrameCount)
+		return false;
+
+	//point base class sprite at frame data, read in place
+	setSource(FrameData + (frame * MATRIX_DIM), FrameProgmem);
+	
+	//update current frame
+	CurrentFrame = frame;
+
+	return true;
 }
 
 void MAXSprite_StraightLine::initStraightLine(uint8_t length, uint8_t thickness, bool vertical /*= false*/, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
@@ -401,12 +1234,10 @@ void MAXSprite_StraightLine::initStraightLine(uint8_t length, uint8_t thickness,
 	uint8_t width = vertical ? line_thickness : line_length;
 	uint8_t height = vertical ? line_length : line_thickness;
 	
-	//generate line sprite
-	uint8_t line_data[8];
+	//generate line sprite (same rows as MAXShape_Line)
+	uint8_t line_data[MATRIX_DIM];
 	for (uint8_t i = 0; i < MATRIX_DIM; i++)
-	{
-		line_data[i] = i < height ? 0xFF << (MATRIX_DIM - width) : 0x00;
-	}
+		line_data[i] = MAXShape::lineRow(line_length, line_thickness, vertical, i);
 
 	//store local data
 	Length = line_length;
@@ -430,24 +1261,13 @@ MAXSprite_Rectangle::MAXSprite_Rectangle(uint8_t width, uint8_t height, uint8_t
 void MAXSprite_Rectangle::initRectangle(uint8_t width, uint8_t height, uint8_t border_thickness /*= 1*/, bool filled /*= false*/, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
 {
 	//check if border thickness is valid (use maximum valid value if too thick, border thickness of 1 for smallest dim of 1)
-	uint8_t smallest_dim = min(width, height);
-	uint8_t max_border_thickness = smallest_dim > 1 ? smallest_dim / 2 : 1;
-	BorderThickness = (border_thickness > max_border_thickness) ? max_border_thickness : border_thickness;
-
-	//generate square sprite
-	uint8_t rectangle_data[8];
+	BorderThickness = MAXShape::rectangleBorder(width, height, border_thickness);
+	Filled = filled;
 
+	//generate rectangle sprite (same rows as MAXShape_Rectangle)
+	uint8_t rectangle_data[MATRIX_DIM];
 	for (uint8_t i = 0; i < MATRIX_DIM; i++)
-	{
-		if (i < BorderThickness)
-			rectangle_data[i] = 0xFF << (MATRIX_DIM - width);
-		else if (i < height - BorderThickness)
-			rectangle_data[i] = filled ? 0xFF << (MATRIX_DIM - width) : (0xFF << (MATRIX_DIM - BorderThickness)) | (((0xFF >> (MATRIX_DIM - BorderThickness)) << (MATRIX_DIM - width)));
-		else if (i < height)
-			rectangle_data[i] = 0xFF << (MATRIX_DIM - width);
-		else
-			rectangle_data[i] = 0x00;
-	}
+		rectangle_data[i] = MAXShape::rectangleRow(width, height, BorderThickness, filled, i);
 
 	//initialize base class
 	MAXSprite::initSprite(rectangle_data, width, height, position_x, position_y, position_constraints, show);
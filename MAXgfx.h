@@ -5,13 +5,72 @@
 
 #if defined(ARDUINO) && ARDUINO >= 100
 	#include "arduino.h"
-#else
+#elif defined(ARDUINO)
 	#include "WProgram.h"
+#else
+	//host build, output through MAXDriver_Sim
+	#include <stdint.h>
+	#include <stdlib.h>
+	#include <string.h>
+#endif
+
+//flash access on cores without (or with emulated) program memory
+#ifndef PROGMEM
+	#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+	#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#endif
+
+//compiler barrier, keeps memory accesses from moving across a buffer hand over between loop and interrupt
+#ifndef MAXGFX_BARRIER
+	#define MAXGFX_BARRIER() __asm__ __volatile__("" ::: "memory")
 #endif
 
-#include <MAX72XX.h>
+//no aliasing between the arrays a batch loop works on, lets the compiler vectorise it without runtime checks
+#ifndef MAXGFX_RESTRICT
+	#define MAXGFX_RESTRICT __restrict__
+#endif
+
+#include "MAXgfx_Driver.h"
+#include "MAXgfx_Bitmap.h"
+
+#ifndef MATRIX_DIM
+	#define MATRIX_DIM 8
+#endif
+
+/** Orientation of an 8x8 block: transpose first (if set), then mirror left to right and/or top to bottom */
+enum enumTransform : uint8_t {
+	TransformNone = 0x00,
+	TransformFlipH = 0x01,
+	TransformFlipV = 0x02,
+	TransformRotate180 = 0x03,
+	TransformTranspose = 0x04,
+	TransformRotate90 = 0x05,		//clockwise
+	TransformRotate270 = 0x06,		//clockwise (90 anticlockwise)
+	TransformAntiTranspose = 0x07
+};
+
+//transform equal to applying first, then then
+inline uint8_t MAXComposeTransform(uint8_t first, uint8_t then)
+{
+	//transposing swaps the axes earlier flips act on
+	if (then & TransformTranspose)
+		first = ((first & TransformTranspose) ^ TransformTranspose) | ((first & TransformFlipH) << 1) | ((first & TransformFlipV) >> 1);
 
-#define SPRITE_LOCATION_CNT 8
+	return first ^ (then & TransformRotate180);
+}
+
+//transform undoing transform (only the quarter turns aren't their own inverse)
+inline uint8_t MAXInverseTransform(uint8_t transform)
+{
+	return (transform == TransformRotate90 || transform == TransformRotate270) ? transform ^ TransformRotate180 : transform;
+}
+
+//sprite/layer capacity of a MAXgfx (MAXgfx_Chain sets its own)
+#ifndef SPRITE_LOCATION_CNT
+	#define SPRITE_LOCATION_CNT 8
+#endif
 #define SPRITE_LOCATION_0 0x01
 #define SPRITE_LOCATION_1 0x02
 #define SPRITE_LOCATION_2 0x04
@@ -32,9 +91,11 @@ struct SpriteInitStruct
 	bool Show = true;
 
 	SpriteInitStruct(uint8_t* data, uint8_t width, uint8_t height, int position_x = 0, int position_y = 0, uint8_t position_constraints = 0x00, bool show = true) :
-		Data(data), Width(width), Height(height), PositionX(PositionX), PositionY(position_y), PositionConstraints(position_constraints), Show(show) {}
+		Data(data), Width(width), Height(height), PositionX(position_x), PositionY(position_y), PositionConstraints(position_constraints), Show(show) {}
 };
 
+class MAXSpatialIndex_Base;
+
 class MAXSprite
 {
 
@@ -50,11 +111,34 @@ public:
 		AllEdges = 0x0F
 	};
 
+	//what batch motion (MAXgfx_Base::moveSprites) does at the edges set in the position constraints
+	enum enumEdgePolicy : uint8_t {
+		EdgeStop,		//stop at the edge, as setPosition does
+		EdgeBounce,		//reflect off the edge, velocity reversed
+		EdgeWrap		//leave across the edge and come back in at the opposite one
+	};
+
 protected:
 
-	//sprite data
+	//sprite data (copied sprites, masked to sprite size on load)
 	uint8_t SpriteData[MATRIX_DIM];
 
+	//external sprite data read in place (NULL = use SpriteData), in flash if SourceProgmem is set
+	const uint8_t* Source = NULL;
+	bool SourceProgmem = false;
+
+	//orientation (enumTransform). Copied data is transformed in place, external data is transformed into SpriteData
+	//once per change, so a transformed sprite costs nothing extra per frame. Width and Height are the transformed size
+	uint8_t Transform = TransformNone;
+
+	//spatial index the sprite is in (kept up to date on every position or size change). Not copied with the sprite:
+	//a copy starts outside any index, assignment keeps the destination's own entry
+	MAXSpatialIndex_Base* Index = NULL;
+	uint16_t IndexEntry = 0;
+
+	friend class MAXSpatialIndex_Base;
+	friend class MAXgfx_Base;
+
 	//Width and height of sprite
 	uint8_t Width = 0;
 	uint8_t Height = 0;
@@ -62,6 +146,9 @@ protected:
 	//pointer to base sprite
 	uint8_t DisplayData[MATRIX_DIM];
 
+	//DisplayData needs to be re-rendered (position, data or size changed)
+	bool DisplayDataDirty = true;
+
 	//sprite position
 	int PositionX;
 	int PositionY;
@@ -69,6 +156,15 @@ protected:
 	//constraints on position (stop sprite from moving past edges)
 	uint8_t PositionConstraints;
 
+	//size of the area the sprite is positioned in (whole display for chained modules)
+	int BoundsWidth = MATRIX_DIM;
+	int BoundsHeight = MATRIX_DIM;
+
+	//batch motion: pixels per MAXgfx_Base::moveSprites step, and behaviour at constrained edges (enumEdgePolicy)
+	int8_t VelocityX = 0;
+	int8_t VelocityY = 0;
+	uint8_t EdgePolicy = EdgeStop;
+
 	//sprite is to be displayed
 	bool Show;
 
@@ -86,20 +182,59 @@ protected:
 	//detect on edge, over edge, past edge results
 	void detectEdges();
 
+	//re-render DisplayData if required
 	void updateDisplayData();
 
+	//mark DisplayData for re-rendering on next read
+	void invalidateDisplayData() { DisplayDataDirty = true; }
 
+	//set size, position and visibility after sprite data has been set
+	void initProperties(uint8_t width, uint8_t height, int position_x, int position_y, uint8_t position_constraints, bool show);
+
+	//read a row of external sprite data
+	uint8_t readSourceRow(uint8_t row) { return SourceProgmem ? pgm_read_byte(Source + row) : Source[row]; }
+
+	//transform SpriteData in place (relative to its current orientation)
+	void transformSpriteData(uint8_t transform);
+
+	//fill SpriteData from external data of the given (untransformed) size and apply Transform
+	void cacheSource(uint8_t width, uint8_t height);
 
 public:
 
 	MAXSprite() {};
+	MAXSprite(const MAXSprite& other) { *this = other; }
+	MAXSprite& operator=(const MAXSprite& other);
 	MAXSprite(const uint8_t* data, uint8_t width, uint8_t height, int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true); 
 	void initSprite(const uint8_t* data, uint8_t width, uint8_t height, int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true);
+
+	//initialize with data in flash (PROGMEM), read in place rather than copied to RAM
+	void initSprite_P(const uint8_t* data, uint8_t width, uint8_t height, int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true);
+
+	//read sprite data in place from data (in flash if progmem is set), data must stay valid while in use
+	void setSource(const uint8_t* data, bool progmem = false);
+	bool isSourceCopied() { return !Source; }
+
+	//rows are held in SpriteData (copied, or external data cached for a transform)
+	bool hasSpriteData() { return !Source || Transform; }
+
+	//orientation, set absolute or added to the current one (e.g. rotate(TransformRotate90) turns a quarter clockwise)
+	void setTransform(uint8_t transform);
+	void rotate(uint8_t transform) { setTransform(MAXComposeTransform(Transform, transform)); }
+	uint8_t getTransform() { return Transform; }
 	
 	//sprite position setters
 	void setPosition(int position_x, int position_y);
 	void move(int distance_x, int distance_y);
 	void setPositionConstraints(uint8_t constraints);
+	void setBounds(int width, int height);
+
+	//batch motion settings, applied by MAXgfx_Base::moveSprites. setPosition and move always stop at constrained edges
+	void setVelocity(int8_t velocity_x, int8_t velocity_y) { VelocityX = velocity_x; VelocityY = velocity_y; }
+	int8_t getVelocityX() { return VelocityX; }
+	int8_t getVelocityY() { return VelocityY; }
+	void setEdgePolicy(uint8_t policy) { EdgePolicy = policy; }
+	uint8_t getEdgePolicy() { return EdgePolicy; }
 
 	//show/hide public methods
 	void show() { Show = true; }
@@ -110,7 +245,7 @@ public:
 	//edge detection getters
 	bool onMatrixEdge(enumEdges edge) { return OnEdgeDectionResults & edge; }
 	uint8_t onMatrixEdge() { return OnEdgeDectionResults; }
-	bool overMatrixEdge(enumEdges edge) { return OverEdgeDetectionResults & OverEdgeDetectionResults; }
+	bool overMatrixEdge(enumEdges edge) { return OverEdgeDetectionResults & edge; }
 	uint8_t overMatrixEdge() { return OverEdgeDetectionResults; }
 	bool outOfMatrixBounds(enumEdges edge) { return OutOfBoundsDetectionResults & edge; }
 	uint8_t outOfMatrixBounds() { return OutOfBoundsDetectionResults; }
@@ -125,30 +260,43 @@ public:
 	const uint8_t* getDisplayData();
 	uint8_t getDisplayRow(uint8_t row);
 
+	//return copied (or transformed) sprite data (before positioning, masked to sprite size), MSB is left column of sprite
+	const uint8_t* getSpriteData() { return SpriteData; }
+
+	//return sprite row (before positioning, masked to sprite size, transformed) from copied or external data
+	uint8_t getSpriteRow(uint8_t row)
+	{
+		if (row >= Height) return 0x00;
+		return hasSpriteData() ? SpriteData[row] : readSourceRow(row) & (uint8_t)~(0xFF >> Width);
+	}
+
 	uint8_t isTouchingSprite(MAXSprite& sprite);
 	bool isTouchingSprite(MAXSprite& sprite, uint8_t edges) { return (isTouchingSprite(sprite) == edges); }
 };
 
-/** A fixed-width sprite with multiple frames */
-class MAXSprite_MultiFrame : public MAXSprite
+/** Sprite with a sequence of frames, stepped by nextFrame (by hand or by a MAXScheduler).
+ *  Derived classes hold the frames and load one into the sprite in loadFrame */
+class MAXSprite_Animated : public MAXSprite
 {
 protected:
 	//number of frames in animation
-	uint8_t FrameCount;
-	uint8_t* FrameData;
-	uint8_t CurrentFrame = 0;
+	uint16_t FrameCount = 0;
+	uint16_t CurrentFrame = 0;
 
 	bool reverse = false;
 
-	void forwardFrame();
-	void reverseFrame();
-
 public:
 
-	MAXSprite_MultiFrame(uint8_t** data, uint8_t frame_count, uint8_t width, uint8_t height, int position_x = 0, int position_y = 0, bool constrain_pos = false, bool show = true);
+	virtual ~MAXSprite_Animated() {}
 
-	bool loadFrame(uint8_t index);
-	void nextFrame();
+	//show frame, returns false if there is no such frame
+	virtual bool loadFrame(uint16_t frame) = 0;
+
+	//step one frame in the current direction, wrapping round at either end
+	virtual void nextFrame();
+
+	uint16_t getFrameCount() { return FrameCount; }
+	uint16_t getCurrentFrame() { return CurrentFrame; }
 
 	//direction public methods
 	void setDirForward() { reverse = false; }
@@ -157,6 +305,24 @@ public:
 	bool isReversed() { return reverse; }
 };
 
+/** A fixed-width sprite with multiple frames */
+class MAXSprite_MultiFrame : public MAXSprite_Animated
+{
+protected:
+	//frames stored back to back, MATRIX_DIM bytes each, read in place
+	const uint8_t* FrameData;
+	bool FrameProgmem = false;
+
+public:
+
+	MAXSprite_MultiFrame(uint8_t** data, uint8_t frame_count, uint8_t width, uint8_t height, int position_x = 0, int position_y = 0, bool constrain_pos = false, bool show = true);
+
+	//frames read in place from RAM or flash (progmem set), RAM use doesn't depend on frame count
+	MAXSprite_MultiFrame(const uint8_t* frames, uint8_t frame_count, uint8_t width, uint8_t height, bool progmem, int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true);
+
+	bool loadFrame(uint16_t frame);
+};
+
 class MAXSprite_Rectangle : public MAXSprite
 {
 protected:
@@ -230,44 +396,315 @@ public:
 
 };
 
-class MAXgfx
+//invalid layer handle / end of layer list
+#define LAYER_NONE 0xFF
+
+/** Layer slot in a MAXgfx layer pool, linked bottom to top. Holds either a sprite or a drawable */
+struct MAXLayer
+{
+	MAXSprite* Sprite;
+	MAXDrawable* Drawable;
+	uint8_t Blend;
+	uint8_t Below;
+	uint8_t Above;
+};
+
+/** Pair of overlapping sprites found by MAXgfx_Base::findCollisions */
+struct SpriteCollision
+{
+	uint8_t Layer1;
+	uint8_t Layer2;
+
+	//overlapping pixels, in the coordinates of the sprite on Layer1
+	uint8_t Mask[MATRIX_DIM];
+};
+
+/** Edge event of a sprite moved by MAXgfx_Base::moveSprites: it hit a constrained edge or its edge detection changed */
+struct SpriteEdgeEvent
+{
+	uint8_t Layer;
+
+	//constrained edges the sprite stopped at, bounced off or wrapped across this step
+	uint8_t Hit;
+
+	//edge detection results after the step (as MAXSprite::onMatrixEdge, overMatrixEdge, outOfMatrixBounds)
+	uint8_t OnEdge;
+	uint8_t OverEdge;
+	uint8_t OutOfBounds;
+};
+
+/** Sprite compositor for one or more cascaded MAX72XX modules.
+ *  The framebuffer is row-major, (MATRIX_DIM * ModuleRows) rows of ModuleCols bytes, MSB = leftmost pixel.
+ *  Modules are numbered left to right, top to bottom; module 0 is the first device in the chain (nearest DIN). */
+class MAXgfx_Base
 {
 
 protected:
 
-	MAX72XX MAX;
+	//output stage
+	MAXDriver& MAX;
+
+	//display size in modules
+	uint8_t ModuleCols;
+	uint8_t ModuleRows;
 	
-	MAXSprite* Sprites[SPRITE_LOCATION_CNT];
-	uint8_t DisplayData[MATRIX_DIM];
+	//layer pool (storage owned by derived class), used layers are linked bottom to top, unused ones form a free list
+	MAXLayer* Layers;
+	uint8_t LayerCapacity;
+	uint8_t LayerCount = 0;
+	uint8_t BottomLayer = LAYER_NONE;
+	uint8_t TopLayer = LAYER_NONE;
+	uint8_t FreeLayer;
+
+	//framebuffer and copy of the rows last written to the MAX72XX digit registers (storage owned by derived class)
+	MAXBitmap FrameBuffer;
+	uint8_t* DisplayData;
+	uint8_t* SentData;
+	bool SentDataValid = false;
+
+	//double buffering: FrameBuffer is composited into BackData while DisplayData (front) is sent.
+	//present() sets SwapPending, the refresh stage swaps the buffers when it starts its next frame and clears it.
+	//one writer per side, so the flag is all the synchronisation an interrupt or DMA sender needs
+	uint8_t* BackData = NULL;
+	volatile bool SwapPending = false;
+
+	//row write statistics (one row = one digit register across the whole chain)
+	uint32_t RowsWritten = 0;
+	uint32_t RowsSkipped = 0;
+
+	//next digit row of an incremental refresh (MATRIX_DIM when no refresh is in progress)
+	uint8_t RefreshDigit = MATRIX_DIM;
+
+	//device settings (applied to every module)
+	uint8_t Intensity = 0x07;
+	bool ShutDown = false;
+	bool TestMode = false;
+
+	MAXgfx_Base(MAXDriver& driver, uint8_t module_cols, uint8_t module_rows, uint8_t* display_data, uint8_t* sent_data, MAXLayer* layers, uint8_t layer_capacity);
+
+	//write the same value to a register on every device in one transaction
+	void writeRegisterAll(uint8_t reg, uint8_t data);
+
+	//orientation applied to every module's 8x8 block on output (modules mounted rotated or mirrored)
+	uint8_t ModuleTransform = TransformNone;
+
+	//write one digit register on every device in one transaction
+	void writeDigitRow(uint8_t digit);
+	bool isDigitRowChanged(uint8_t digit);
+
+	//byte for one module's digit register, with ModuleTransform applied
+	uint8_t getDeviceRow(uint8_t module_col, uint8_t module_row, uint8_t digit)
+	{
+		const uint8_t* block = DisplayData + module_row * MATRIX_DIM * ModuleCols + module_col;
+		return ModuleTransform ? getTransformedRow(block, digit) : block[digit * ModuleCols];
+	}
+	uint8_t getTransformedRow(const uint8_t* block, uint8_t digit);
 
-public:
+	//combine sprite with framebuffer at its position
+	void blitSprite(MAXSprite& sprite, uint8_t blend);
 
-	MAXgfx(int LOAD_PIN) : Sprites(), MAX(LOAD_PIN) {}
+	//layer list helpers
+	uint8_t insertLayer(MAXSprite* sprite, MAXDrawable* drawable, uint8_t blend, uint8_t below, uint8_t above);
+	void linkLayer(uint8_t layer, uint8_t below, uint8_t above);
+	void unlinkLayer(uint8_t layer);
+	bool isLayerUsed(uint8_t layer) { return layer < LayerCapacity && (Layers[layer].Sprite || Layers[layer].Drawable); }
 
-	void init() { MAX.init(); };
+	//refresh stage side of a buffer hand over
+	void swapBuffers();
 
-	bool addSprite(MAXSprite& sprite);
-	bool removeSprite(uint8_t location);
-	bool replaceSprite(uint8_t location, MAXSprite sprite);
+public:
 
-	// TODO: add master transpose
+	//start the driver and configure every device in the chain (no decode, scan all digits)
+	void init();
+
+	//force the next updateDisplay to rewrite every row (e.g. after the device has been reset externally)
+	void invalidateDisplay() { SentDataValid = false; }
+
+	//row write statistics getters
+	uint32_t getRowsWritten() { return RowsWritten; }
+	uint32_t getRowsSkipped() { return RowsSkipped; }
+	void resetRowCounters() { RowsWritten = 0; RowsSkipped = 0; }
+
+	//display dimension getters
+	uint8_t getModuleCols() { return ModuleCols; }
+	uint8_t getModuleRows() { return ModuleRows; }
+	int getDisplayWidth() { return ModuleCols * MATRIX_DIM; }
+	int getDisplayHeight() { return ModuleRows * MATRIX_DIM; }
+
+	//framebuffer (back buffer when double buffered), can be drawn into directly between composite() and present()/refresh()
+	MAXBitmap& getFrameBuffer() { return FrameBuffer; }
+
+	//immediate mode drawing into the framebuffer, after composite() (drawn over the layers) or instead of it
+	//(clearFrame() then draw, for dashboards redrawn every frame without any sprites)
+	void clearFrame() { FrameBuffer.clear(); }
+	void setPixel(int x, int y, bool on = true) { FrameBuffer.setPixel(x, y, on); }
+	bool getPixel(int x, int y) { return FrameBuffer.getPixel(x, y); }
+	void drawLine(int x0, int y0, int x1, int y1, bool on = true) { FrameBuffer.drawLine(x0, y0, x1, y1, on); }
+	void drawRect(int x, int y, int width, int height, bool on = true) { FrameBuffer.drawRect(x, y, width, height, on); }
+	void fillRect(int x, int y, int width, int height, bool on = true) { FrameBuffer.fillRect(x, y, width, height, on); }
+	void drawCircle(int center_x, int center_y, int radius, bool on = true) { FrameBuffer.drawCircle(center_x, center_y, radius, on); }
+	void fillCircle(int center_x, int center_y, int radius, bool on = true) { FrameBuffer.fillCircle(center_x, center_y, radius, on); }
+	void drawBitmap(const MAXBitmap& bitmap, int x, int y, uint8_t blend = BlendOr) { FrameBuffer.blit(bitmap, x, y, blend); }
+
+	//scroll the framebuffer contents (see MAXBitmap::scroll), for scenes kept in the framebuffer between frames
+	//instead of composited from layers: scroll, draw what has come into view, refresh() sends only changed rows.
+	//double buffered displays swap buffers on present(), so scroll after composite() there
+	void scroll(int distance_x, int distance_y, bool wrap = false) { FrameBuffer.scroll(distance_x, distance_y, wrap); }
+
+	//layers, handles stay valid until the layer is removed
+	uint8_t addLayer(MAXSprite& sprite, uint8_t blend = BlendOr);
+	uint8_t addLayerAbove(uint8_t layer, MAXSprite& sprite, uint8_t blend = BlendOr);
+	uint8_t addLayerBelow(uint8_t layer, MAXSprite& sprite, uint8_t blend = BlendOr);
+	uint8_t addLayer(MAXDrawable& drawable, uint8_t blend = BlendOr);
+	uint8_t addLayerAbove(uint8_t layer, MAXDrawable& drawable, uint8_t blend = BlendOr);
+	uint8_t addLayerBelow(uint8_t layer, MAXDrawable& drawable, uint8_t blend = BlendOr);
+	bool removeLayer(uint8_t layer);
+
+	//z-order
+	bool moveLayerToTop(uint8_t layer);
+	bool moveLayerToBottom(uint8_t layer);
+	bool moveLayerAbove(uint8_t layer, uint8_t other);
+	bool moveLayerBelow(uint8_t layer, uint8_t other);
+
+	//layer getters/setters
+	bool setLayerBlend(uint8_t layer, uint8_t blend);
+	uint8_t getLayerBlend(uint8_t layer) { return isLayerUsed(layer) ? Layers[layer].Blend : (uint8_t)BlendOr; }
+	MAXSprite* getLayerSprite(uint8_t layer) { return isLayerUsed(layer) ? Layers[layer].Sprite : NULL; }
+	MAXDrawable* getLayerDrawable(uint8_t layer) { return isLayerUsed(layer) ? Layers[layer].Drawable : NULL; }
+	uint8_t getLayerCount() { return LayerCount; }
+	uint8_t getLayerCapacity() { return LayerCapacity; }
+
+	//layer iteration, bottom to top
+	uint8_t getBottomLayer() { return BottomLayer; }
+	uint8_t getTopLayer() { return TopLayer; }
+	uint8_t getLayerAbove(uint8_t layer) { return isLayerUsed(layer) ? Layers[layer].Above : LAYER_NONE; }
+	uint8_t getLayerBelow(uint8_t layer) { return isLayerUsed(layer) ? Layers[layer].Below : LAYER_NONE; }
+
+	//sprite locations: position in z-order, 0 = bottom
+	bool addSprite(MAXSprite& sprite) { return addLayer(sprite) != LAYER_NONE; }
+	bool removeSprite(uint8_t location) { return removeLayer(getLayerAt(location)); }
+	bool replaceSprite(uint8_t location, MAXSprite& sprite);
+	uint8_t getLayerAt(uint8_t location);
+
+	//display-wide orientation: transform (enumTransform) applied to each module's block as it's sent, so the
+	//framebuffer stays in display coordinates whichever way round the modules are mounted. Resends everything
+	void setModuleTransform(uint8_t transform) { ModuleTransform = transform & TransformAntiTranspose; invalidateDisplay(); }
+	uint8_t getModuleTransform() { return ModuleTransform; }
+
+	//composite all layers and send changed rows
 	void updateDisplay();
 
+	//build the framebuffer from all shown layers
+	void composite();
+	//send changed rows of the framebuffer to the devices
+	void refresh();
+
+	//incremental refresh: start a refresh, then send at most max_rows changed rows per refreshRows call so the
+	//bus time of a frame can be spread over several loop iterations. refreshRows returns true once the frame is sent
+	void beginRefresh() { RefreshDigit = 0; }
+	bool refreshRows(uint8_t max_rows);
+	bool isRefreshPending() { return RefreshDigit < MATRIX_DIM; }
+
+	//double buffering (see MAXgfx_DoubleBuffered), back_data is a second framebuffer-sized buffer, NULL to turn off
+	void setBackBuffer(uint8_t* back_data);
+	bool isDoubleBuffered() { return BackData != NULL; }
+
+	//hand the composited frame to the refresh stage. Double buffered, this returns false while the previous frame hasn't
+	//been taken yet; otherwise refreshRows (from the loop or an interrupt) takes the frame and the framebuffer becomes
+	//free to composite the next one while this one goes out. Single buffered, it starts a refresh of the framebuffer
+	bool present();
+	//presented frame not yet taken (double buffered) or not yet sent (single buffered), don't composite
+	bool isFramePending() { return BackData ? SwapPending : isRefreshPending(); }
+
 	MAXSprite* getSprite(uint8_t location);
 	void getSpriteCopy(uint8_t location, MAXSprite* sprite);
 
+	//pixel accurate collision tests (bounding box reject, then AND of sprite data), mask receives overlapping pixels in sprite1 coordinates
+	static bool isOverlapping(MAXSprite& sprite1, MAXSprite& sprite2, uint8_t* mask = NULL);
+	bool isOverlapping(uint8_t layer1, uint8_t layer2, uint8_t* mask = NULL);
+
+	//find all overlapping pairs of shown sprites in one pass, returns number of pairs stored
+	uint8_t findCollisions(SpriteCollision* collisions, uint8_t max_collisions);
+
 	void setSpritePosition(uint8_t index , int position_x, int position_y);
-	void moveSprite(int move_x, int move_y);
-
-	//wrapper functions for MAX7221 class
-	void setIntensity(uint8_t intensity) { MAX.setIntensity(intensity); }
-	void setShutDownMode(bool shutdown) { MAX.setShutDownMode(shutdown); }
-	void setTestMode(bool test_mode) { MAX.setTestMode(test_mode); }
-	uint8_t getIntensity() { return MAX.getIntensity(); }
-	bool getShutdownMode() { return MAX.getShutdownMode(); }
-	bool getDisplayTestMode() { return MAX.getDisplayTestMode(); }
+	void moveSprite(uint8_t location, int distance_x, int distance_y);
+
+	//batch motion: add every sprite's velocity to its position in one pass over the layers, resolving its edge policy
+	//and edge detection. Sprites that hit an edge or whose edge detection changed are stored in events, returns the
+	//number stored (every sprite is moved, whether or not its event fits)
+	uint8_t moveSprites(SpriteEdgeEvent* events = NULL, uint8_t max_events = 0);
+
+	//device settings, applied to all modules in the chain
+	void setIntensity(uint8_t intensity);
+	void setShutDownMode(bool shutdown);
+	void setTestMode(bool test_mode);
+	uint8_t getIntensity() { return Intensity; }
+	bool getShutdownMode() { return ShutDown; }
+	bool getDisplayTestMode() { return TestMode; }
 };
 
+/** A single MAX72XX module */
+class MAXgfx : public MAXgfx_Base
+{
 
+protected:
+
+#if defined(ARDUINO)
+	MAXDriver_SPI SPIDriver;
 #endif
 
+	uint8_t FrameData[MATRIX_DIM];
+	uint8_t SentFrameData[MATRIX_DIM];
+	MAXLayer LayerData[SPRITE_LOCATION_CNT];
+
+public:
+
+#if defined(ARDUINO)
+	MAXgfx(int LOAD_PIN) : MAXgfx_Base(SPIDriver, 1, 1, FrameData, SentFrameData, LayerData, SPRITE_LOCATION_CNT), SPIDriver(LOAD_PIN) {}
+#endif
+	MAXgfx(MAXDriver& driver) : MAXgfx_Base(driver, 1, 1, FrameData, SentFrameData, LayerData, SPRITE_LOCATION_CNT) {}
+};
+
+/** A grid of MODULE_COLS x MODULE_ROWS daisy-chained MAX72XX modules sharing one LOAD pin, with up to LAYER_CNT layers */
+template <uint8_t MODULE_COLS, uint8_t MODULE_ROWS = 1, uint8_t LAYER_CNT = SPRITE_LOCATION_CNT>
+class MAXgfx_Chain : public MAXgfx_Base
+{
+
+protected:
+
+#if defined(ARDUINO)
+	MAXDriver_SPI SPIDriver;
+#endif
+
+	uint8_t FrameData[MODULE_COLS * MODULE_ROWS * MATRIX_DIM];
+	uint8_t SentFrameData[MODULE_COLS * MODULE_ROWS * MATRIX_DIM];
+	MAXLayer LayerData[LAYER_CNT];
+
+public:
+
+#if defined(ARDUINO)
+	MAXgfx_Chain(int LOAD_PIN) : MAXgfx_Base(SPIDriver, MODULE_COLS, MODULE_ROWS, FrameData, SentFrameData, LayerData, LAYER_CNT), SPIDriver(LOAD_PIN) {}
+#endif
+	MAXgfx_Chain(MAXDriver& driver) : MAXgfx_Base(driver, MODULE_COLS, MODULE_ROWS, FrameData, SentFrameData, LayerData, LAYER_CNT) {}
+};
+
+/** MAXgfx_Chain with front and back framebuffers, for output from an interrupt or DMA sender:
+ *  the loop calls composite() and present(), the sender calls refreshRows() */
+template <uint8_t MODULE_COLS, uint8_t MODULE_ROWS = 1, uint8_t LAYER_CNT = SPRITE_LOCATION_CNT>
+class MAXgfx_DoubleBuffered : public MAXgfx_Chain<MODULE_COLS, MODULE_ROWS, LAYER_CNT>
+{
+
+protected:
+
+	uint8_t BackFrameData[MODULE_COLS * MODULE_ROWS * MATRIX_DIM];
+
+public:
+
+#if defined(ARDUINO)
+	MAXgfx_DoubleBuffered(int LOAD_PIN) : MAXgfx_Chain<MODULE_COLS, MODULE_ROWS, LAYER_CNT>(LOAD_PIN), BackFrameData() { this->setBackBuffer(BackFrameData); }
+#endif
+	MAXgfx_DoubleBuffered(MAXDriver& driver) : MAXgfx_Chain<MODULE_COLS, MODULE_ROWS, LAYER_CNT>(driver), BackFrameData() { this->setBackBuffer(BackFrameData); }
+};
+
+
+#endif
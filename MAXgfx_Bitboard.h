@@ -0,0 +1,116 @@
+// MAXgfx_Bitboard.h
+
+#ifndef _MAX72XX_GFX_BITBOARD_h
+#define _MAX72XX_GFX_BITBOARD_h
+
+#include <stdint.h>
+#include <string.h>
+
+// 64-bit kernels are slower than byte loops on 8-bit cores, use them everywhere else
+#ifndef MAXGFX_USE_BITBOARD
+	#if defined(__AVR__)
+		#define MAXGFX_USE_BITBOARD 0
+	#else
+		#define MAXGFX_USE_BITBOARD 1
+	#endif
+#endif
+
+/** 8x8 monochrome matrix packed into one 64-bit word.
+ *  Row i is byte i of the word (bits 8i..8i+7), bit 7 of each row is the leftmost pixel,
+ *  so whole-matrix operations are a handful of word operations instead of 8 byte loops. */
+namespace MAXBitboard
+{
+	typedef uint64_t Board;
+
+	//0x01 in every row, multiply by a byte to repeat it in all 8 rows
+	const Board ROWS_LSB = 0x0101010101010101ULL;
+
+	inline Board load(const uint8_t* rows)
+	{
+		Board board;
+		memcpy(&board, rows, sizeof(board));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		board = __builtin_bswap64(board);
+#endif
+		return board;
+	}
+
+	inline void store(Board board, uint8_t* rows)
+	{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		board = __builtin_bswap64(board);
+#endif
+		memcpy(rows, &board, sizeof(board));
+	}
+
+	//move every row right (towards LSB) by distance columns
+	inline Board shiftRight(Board board, uint8_t distance)
+	{
+		return distance >= 8 ? 0 : (board >> distance) & (ROWS_LSB * (uint8_t)(0xFF >> distance));
+	}
+
+	//move every row left (towards MSB) by distance columns
+	inline Board shiftLeft(Board board, uint8_t distance)
+	{
+		return distance >= 8 ? 0 : (board << distance) & (ROWS_LSB * (uint8_t)(0xFF << distance));
+	}
+
+	//move rows down (row i to row i + distance)
+	inline Board shiftDown(Board board, uint8_t distance)
+	{
+		return distance >= 8 ? 0 : board << (distance * 8);
+	}
+
+	//move rows up (row i to row i - distance)
+	inline Board shiftUp(Board board, uint8_t distance)
+	{
+		return distance >= 8 ? 0 : board >> (distance * 8);
+	}
+
+	//move by x columns (positive = right) and y rows (positive = down), shifted out pixels are lost
+	inline Board shift(Board board, int x, int y)
+	{
+		if (x > 0) board = shiftRight(board, x > 8 ? 8 : x);
+		else if (x < 0) board = shiftLeft(board, x < -8 ? 8 : -x);
+
+		if (y > 0) board = shiftDown(board, y > 8 ? 8 : y);
+		else if (y < 0) board = shiftUp(board, y < -8 ? 8 : -y);
+
+		return board;
+	}
+
+	//mirror left to right (column c to column 7 - c)
+	inline Board flipHorizontal(Board board)
+	{
+		board = ((board >> 1) & 0x5555555555555555ULL) | ((board & 0x5555555555555555ULL) << 1);
+		board = ((board >> 2) & 0x3333333333333333ULL) | ((board & 0x3333333333333333ULL) << 2);
+		return ((board >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((board & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	}
+
+	//mirror top to bottom (row r to row 7 - r)
+	inline Board flipVertical(Board board)
+	{
+		return __builtin_bswap64(board);
+	}
+
+	//swap rows and columns (pixel x, y to y, x), three delta swaps
+	inline Board transpose(Board board)
+	{
+		Board t = board ^ (board << 36);
+		board ^= 0xF0F0F0F00F0F0F0FULL & (t ^ (board >> 36));
+		t = 0xCCCC0000CCCC0000ULL & (board ^ (board << 18));
+		board ^= t ^ (t >> 18);
+		t = 0xAA00AA00AA00AA00ULL & (board ^ (board << 9));
+		return board ^ t ^ (t >> 9);
+	}
+
+	//width x height block of set pixels in the top left corner
+	inline Board rectMask(uint8_t width, uint8_t height)
+	{
+		uint8_t row = width >= 8 ? 0xFF : (uint8_t)~(0xFF >> width);
+		Board rows = height >= 8 ? ~(Board)0 : (((Board)1 << (height * 8)) - 1);
+		return (ROWS_LSB * row) & rows;
+	}
+}
+
+#endif
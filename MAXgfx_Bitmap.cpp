@@ -0,0 +1,348 @@
+//
+//
+//
+
+#include "MAXgfx_Bitmap.h"
+
+uint8_t MAXBitmap::fetchBits(const uint8_t* row, uint16_t x) const
+{
+	uint16_t index = x >> 3;
+	uint8_t offset = x & 0x07;
+
+	if (index >= Stride)
+		return 0x00;
+
+	uint8_t bits = row[index] << offset;
+	if (offset && index + 1 < Stride)
+		bits |= row[index + 1] >> (8 - offset);
+
+	return bits;
+}
+
+bool MAXBitmap::getPixel(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= Width || y >= Height)
+		return false;
+
+	return getRow(y)[x >> 3] & (0x80 >> (x & 0x07));
+}
+
+void MAXBitmap::setPixel(int x, int y, bool on /*= true*/)
+{
+	if (x < 0 || y < 0 || x >= Width || y >= Height)
+		return;
+
+	uint8_t* data = getRow(y) + (x >> 3);
+	uint8_t bit = 0x80 >> (x & 0x07);
+
+	if (on)
+		*data |= bit;
+	else
+		*data &= ~bit;
+}
+
+void MAXBitmap::blit(const MAXBitmap& source, int source_x, int source_y, int width, int height, int dest_x, int dest_y, uint8_t blend /*= BlendOr*/)
+{
+	//clip against source bounds
+	if (source_x < 0) { width += source_x; dest_x -= source_x; source_x = 0; }
+	if (source_y < 0) { height += source_y; dest_y -= source_y; source_y = 0; }
+	if (source_x + width > source.Width) width = source.Width - source_x;
+	if (source_y + height > source.Height) height = source.Height - source_y;
+
+	//clip against destination bounds
+	if (dest_x < 0) { width += dest_x; source_x -= dest_x; dest_x = 0; }
+	if (dest_y < 0) { height += dest_y; source_y -= dest_y; dest_y = 0; }
+	if (dest_x + width > Width) width = Width - dest_x;
+	if (dest_y + height > Height) height = Height - dest_y;
+
+	//nothing visible
+	if (width <= 0 || height <= 0)
+		return;
+
+	for (int i = 0; i < height; i++)
+	{
+		const uint8_t* source_row = source.getRow(source_y + i);
+		uint8_t* dest_row = getRow(dest_y + i);
+
+		//one destination byte (or part of one at either end) per step
+		uint16_t x = dest_x;
+		uint16_t sx = source_x;
+		int remaining = width;
+
+		while (remaining > 0)
+		{
+			uint8_t offset = x & 0x07;
+			uint8_t count = (8 - offset < remaining) ? 8 - offset : remaining;
+			uint8_t mask = (uint8_t)(0xFF << (8 - count)) >> offset;
+
+			MAXBlendByte(dest_row + (x >> 3), (source.fetchBits(source_row, sx) >> offset) & mask, mask, blend);
+
+			x += count;
+			sx += count;
+			remaining -= count;
+		}
+	}
+}
+
+void MAXBitmap::fillRect(int x, int y, int width, int height, bool on /*= true*/)
+{
+	//clip
+	if (x < 0) { width += x; x = 0; }
+	if (y < 0) { height += y; y = 0; }
+	if (x + width > Width) width = Width - x;
+	if (y + height > Height) height = Height - y;
+
+	if (width <= 0 || height <= 0)
+		return;
+
+	//masks of first and last byte of each row, bytes in between are written whole
+	uint16_t first = x >> 3;
+	uint16_t last = (x + width - 1) >> 3;
+	uint8_t first_mask = 0xFF >> (x & 0x07);
+	uint8_t last_mask = 0xFF << (7 - ((x + width - 1) & 0x07));
+	if (first == last)
+		first_mask &= last_mask;
+
+	for (uint8_t* row = getRow(y); height > 0; height--, row += Stride)
+	{
+		MAXBlendByte(row + first, on ? first_mask : 0x00, first_mask, BlendOpaque);
+		if (first == last)
+			continue;
+
+		memset(row + first + 1, on ? 0xFF : 0x00, last - first - 1);
+		MAXBlendByte(row + last, on ? last_mask : 0x00, last_mask, BlendOpaque);
+	}
+}
+
+void MAXBitmap::drawRect(int x, int y, int width, int height, bool on /*= true*/)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	drawHLine(x, y, width, on);
+	drawHLine(x, y + height - 1, width, on);
+	drawVLine(x, y + 1, height - 2, on);
+	drawVLine(x + width - 1, y + 1, height - 2, on);
+}
+
+void MAXBitmap::drawLine(int x0, int y0, int x1, int y1, bool on /*= true*/)
+{
+	//straight lines as row masks
+	if (y0 == y1)
+	{
+		drawHLine(x0 < x1 ? x0 : x1, y0, abs(x1 - x0) + 1, on);
+		return;
+	}
+	if (x0 == x1)
+	{
+		drawVLine(x0, y0 < y1 ? y0 : y1, abs(y1 - y0) + 1, on);
+		return;
+	}
+
+	//Bresenham, any angle
+	int dx = abs(x1 - x0);
+	int dy = -abs(y1 - y0);
+	int step_x = x0 < x1 ? 1 : -1;
+	int step_y = y0 < y1 ? 1 : -1;
+	int error = dx + dy;
+
+	while (true)
+	{
+		setPixel(x0, y0, on);
+		if (x0 == x1 && y0 == y1)
+			break;
+
+		int error2 = 2 * error;
+		if (error2 >= dy) { error += dy; x0 += step_x; }
+		if (error2 <= dx) { error += dx; y0 += step_y; }
+	}
+}
+
+void MAXBitmap::drawCircle(int center_x, int center_y, int radius, bool on /*= true*/)
+{
+	if (radius < 0)
+		return;
+
+	//midpoint circle, one octant mirrored 8 ways
+	int x = radius;
+	int y = 0;
+	int error = 1 - radius;
+
+	while (x >= y)
+	{
+		setPixel(center_x + x, center_y + y, on);
+		setPixel(center_x - x, center_y + y, on);
+		setPixel(center_x + x, center_y - y, on);
+		setPixel(center_x - x, center_y - y, on);
+		setPixel(center_x + y, center_y + x, on);
+		setPixel(center_x - y, center_y + x, on);
+		setPixel(center_x + y, center_y - x, on);
+		setPixel(center_x - y, center_y - x, on);
+
+		y++;
+		if (error < 0)
+			error += 2 * y + 1;
+		else
+		{
+			x--;
+			error += 2 * (y - x) + 1;
+		}
+	}
+}
+
+void MAXBitmap::fillCircle(int center_x, int center_y, int radius, bool on /*= true*/)
+{
+	if (radius < 0)
+		return;
+
+	//same outline as drawCircle, filled with row spans
+	int x = radius;
+	int y = 0;
+	int error = 1 - radius;
+
+	while (x >= y)
+	{
+		drawHLine(center_x - x, center_y + y, 2 * x + 1, on);
+		drawHLine(center_x - x, center_y - y, 2 * x + 1, on);
+		drawHLine(center_x - y, center_y + x, 2 * y + 1, on);
+		drawHLine(center_x - y, center_y - x, 2 * y + 1, on);
+
+		y++;
+		if (error < 0)
+			error += 2 * y + 1;
+		else
+		{
+			x--;
+			error += 2 * (y - x) + 1;
+		}
+	}
+}
+
+void MAXBitmap::shiftRowRight(uint8_t* row, uint8_t count, bool wrap)
+{
+	//last count pixels come back in on the left
+	uint8_t carry = fetchBits(row, Width - count) & (uint8_t)~(0xFF >> count);
+
+	for (uint16_t i = Stride - 1; i > 0; i--)
+		row[i] = (row[i] >> count) | (row[i - 1] << (8 - count));
+	row[0] >>= count;
+
+	//clear anything shifted into the padding past Width
+	if (Width & 0x07)
+		row[Stride - 1] &= (uint8_t)~(0xFF >> (Width & 0x07));
+
+	if (wrap)
+		row[0] |= carry;
+}
+
+void MAXBitmap::shiftRowLeft(uint8_t* row, uint8_t count, bool wrap)
+{
+	//first count pixels come back in on the right
+	uint8_t carry = row[0] & (uint8_t)~(0xFF >> count);
+
+	for (uint16_t i = 0; i + 1 < Stride; i++)
+		row[i] = (row[i] << count) | (row[i + 1] >> (8 - count));
+	row[Stride - 1] <<= count;
+
+	//clear last count pixels and padding (padding may have been shifted in), then put carry there
+	uint16_t x = Width - count;
+	uint16_t index = x >> 3;
+	uint8_t offset = x & 0x07;
+
+	row[index] &= ~(0xFF >> offset);
+	if (index + 1 < Stride)
+		memset(row + index + 1, 0x00, Stride - index - 1);
+
+	if (wrap)
+	{
+		row[index] |= carry >> offset;
+		if (offset + count > 8)
+			row[index + 1] |= carry << (8 - offset);
+	}
+}
+
+void MAXBitmap::reverseRows(uint16_t first, uint16_t last)
+{
+	while (first + 1 < last)
+	{
+		uint8_t* a = getRow(first++);
+		uint8_t* b = getRow(--last);
+		for (uint16_t i = 0; i < Stride; i++)
+		{
+			uint8_t swap = a[i];
+			a[i] = b[i];
+			b[i] = swap;
+		}
+	}
+}
+
+void MAXBitmap::scroll(int distance_x, int distance_y, bool wrap /*= false*/)
+{
+	if (!Width || !Height)
+		return;
+
+	//vertical: whole rows
+	if (distance_y)
+	{
+		if (wrap)
+		{
+			//rotate rows in place by three reversals
+			uint16_t count = ((distance_y % Height) + Height) % Height;
+			if (count)
+			{
+				reverseRows(0, Height);
+				reverseRows(0, count);
+				reverseRows(count, Height);
+			}
+		}
+		else if (abs(distance_y) >= Height)
+			clear();
+		else if (distance_y > 0)
+		{
+			memmove(getRow(distance_y), getRow(0), (Height - distance_y) * Stride);
+			memset(getRow(0), 0x00, distance_y * Stride);
+		}
+		else
+		{
+			memmove(getRow(0), getRow(-distance_y), (Height + distance_y) * Stride);
+			memset(getRow(Height + distance_y), 0x00, -distance_y * Stride);
+		}
+	}
+
+	//horizontal: bit shifts along each row, at most 7 pixels per pass
+	if (distance_x)
+	{
+		bool right = distance_x > 0;
+		uint16_t count = abs(distance_x);
+
+		if (wrap)
+		{
+			//shortest way round
+			count %= Width;
+			if (count > Width / 2)
+			{
+				count = Width - count;
+				right = !right;
+			}
+		}
+		else if (count >= Width)
+		{
+			clear();
+			return;
+		}
+
+		for (uint16_t y = 0; y < Height; y++)
+		{
+			uint8_t* row = getRow(y);
+			for (uint16_t remaining = count; remaining; )
+			{
+				uint8_t pass = remaining < 8 ? remaining : 7;
+				if (right)
+					shiftRowRight(row, pass, wrap);
+				else
+					shiftRowLeft(row, pass, wrap);
+				remaining -= pass;
+			}
+		}
+	}
+}
@@ -0,0 +1,165 @@
+// MAXgfx_Bitmap.h
+
+#ifndef _MAX72XX_GFX_BITMAP_h
+#define _MAX72XX_GFX_BITMAP_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#elif defined(ARDUINO)
+	#include "WProgram.h"
+#else
+	#include <stdint.h>
+	#include <stdlib.h>
+	#include <string.h>
+#endif
+
+/** How a layer is combined with the layers below it */
+enum enumBlend : uint8_t {
+	BlendOr = 0x00,		//set sprite pixels
+	BlendXor = 0x01,	//invert sprite pixels
+	BlendErase = 0x02,	//clear sprite pixels (AND-NOT)
+	BlendOpaque = 0x03	//replace everything under the sprite's bounding box
+};
+
+//combine bits into a byte, mask is the part of the byte covered by the source's bounding box
+inline void MAXBlendByte(uint8_t* output, uint8_t bits, uint8_t mask, uint8_t blend)
+{
+	switch (blend)
+	{
+	case BlendXor: *output ^= bits; break;
+	case BlendErase: *output &= ~bits; break;
+	case BlendOpaque: *output = (*output & ~mask) | bits; break;
+	default: *output |= bits; break;
+	}
+}
+
+/** Monochrome bitmap of any size, packed row-major with rows padded to whole bytes, MSB = leftmost pixel.
+ *  Does not own its data, see MAXCanvas for a bitmap with storage. */
+class MAXBitmap
+{
+
+protected:
+
+	uint8_t* Data;
+	uint16_t Width;
+	uint16_t Height;
+
+	//bytes per row
+	uint16_t Stride;
+
+	//8 pixels starting at column x of a row, MSB first (pixels past the row end read as 0)
+	uint8_t fetchBits(const uint8_t* row, uint16_t x) const;
+
+	//scroll helpers: shift one row by 1 - 7 pixels, reverse the order of rows first to last - 1
+	void shiftRowRight(uint8_t* row, uint8_t count, bool wrap);
+	void shiftRowLeft(uint8_t* row, uint8_t count, bool wrap);
+	void reverseRows(uint16_t first, uint16_t last);
+
+public:
+
+	MAXBitmap() : Data(NULL), Width(0), Height(0), Stride(0) {}
+	MAXBitmap(uint8_t* data, uint16_t width, uint16_t height) : Data(data), Width(width), Height(height), Stride((width + 7) / 8) {}
+
+	//bytes needed for a bitmap of the given size
+	static uint16_t getBufferSize(uint16_t width, uint16_t height) { return ((width + 7) / 8) * height; }
+
+	//dimension getters
+	uint16_t getWidth() const { return Width; }
+	uint16_t getHeight() const { return Height; }
+	uint16_t getStride() const { return Stride; }
+
+	//data access
+	uint8_t* getData() { return Data; }
+	const uint8_t* getRow(uint16_t y) const { return Data + y * Stride; }
+	uint8_t* getRow(uint16_t y) { return Data + y * Stride; }
+
+	//pixel access, coordinates outside the bitmap are ignored
+	bool getPixel(int x, int y) const;
+	void setPixel(int x, int y, bool on = true);
+
+	//clear all pixels (or set all if set is true)
+	void clear(bool set = false) { memset(Data, set ? 0xFF : 0x00, Stride * Height); }
+
+	//move every pixel by distance_x, distance_y (positive = right/down). Pixels moved out either come back in on the
+	//opposite side (wrap) or are lost and the uncovered area is cleared. Bit shifts per row, O(rows x stride)
+	void scroll(int distance_x, int distance_y, bool wrap = false);
+
+	//immediate mode drawing, clipped to the bitmap. on = false clears pixels
+	//rectangles and straight lines write whole bytes with row masks, other shapes go pixel by pixel
+	void fillRect(int x, int y, int width, int height, bool on = true);
+	void drawRect(int x, int y, int width, int height, bool on = true);
+	void drawHLine(int x, int y, int length, bool on = true) { fillRect(x, y, length, 1, on); }
+	void drawVLine(int x, int y, int length, bool on = true) { fillRect(x, y, 1, length, on); }
+	void drawLine(int x0, int y0, int x1, int y1, bool on = true);
+	void drawCircle(int center_x, int center_y, int radius, bool on = true);
+	void fillCircle(int center_x, int center_y, int radius, bool on = true);
+
+	//combine the width x height region at source_x, source_y of source into this bitmap at dest_x, dest_y.
+	//both regions are clipped first, so only visible rows and bytes are read or written
+	void blit(const MAXBitmap& source, int source_x, int source_y, int width, int height, int dest_x, int dest_y, uint8_t blend = BlendOr);
+	void blit(const MAXBitmap& source, int dest_x, int dest_y, uint8_t blend = BlendOr) { blit(source, 0, 0, source.Width, source.Height, dest_x, dest_y, blend); }
+};
+
+/** MAXBitmap with its own WIDTH x HEIGHT storage */
+template <uint16_t WIDTH, uint16_t HEIGHT>
+class MAXCanvas : public MAXBitmap
+{
+
+protected:
+
+	uint8_t CanvasData[((WIDTH + 7) / 8) * HEIGHT];
+
+public:
+
+	MAXCanvas() : MAXBitmap(CanvasData, WIDTH, HEIGHT), CanvasData() {}
+};
+
+/** Anything that can be drawn onto a display as a layer (see MAXgfx_Base::addLayer) */
+class MAXDrawable
+{
+
+protected:
+
+	//drawable is to be displayed
+	bool Show = true;
+
+public:
+
+	//draw into the display framebuffer
+	virtual void draw(MAXBitmap& frame, uint8_t blend) = 0;
+
+	//show/hide public methods
+	void show() { Show = true; }
+	void hide() { Show = false; }
+	bool isShown() { return Show; }
+	bool isHidden() { return !Show; }
+};
+
+/** Display-sized window onto a larger bitmap (scrolling background, level map, wide banner) */
+class MAXViewport : public MAXDrawable
+{
+
+protected:
+
+	const MAXBitmap* Source;
+
+	//top left corner of the window in source coordinates
+	int ViewX;
+	int ViewY;
+
+public:
+
+	MAXViewport(const MAXBitmap& source, int view_x = 0, int view_y = 0) : Source(&source), ViewX(view_x), ViewY(view_y) {}
+
+	void setSource(const MAXBitmap& source) { Source = &source; }
+
+	//window position
+	void setView(int view_x, int view_y) { ViewX = view_x; ViewY = view_y; }
+	void moveView(int distance_x, int distance_y) { ViewX += distance_x; ViewY += distance_y; }
+	int getViewX() { return ViewX; }
+	int getViewY() { return ViewY; }
+
+	void draw(MAXBitmap& frame, uint8_t blend) { frame.blit(*Source, ViewX, ViewY, frame.getWidth(), frame.getHeight(), 0, 0, blend); }
+};
+
+#endif
@@ -0,0 +1,172 @@
+//
+//
+//
+
+#include "MAXgfx_Delta.h"
+
+uint16_t MAXDelta::encode(const uint8_t* frames, uint16_t frame_count, uint8_t key_interval, uint8_t* output, uint16_t max_size)
+{
+	if (!frame_count || !key_interval)
+		return 0;
+
+	uint16_t keyframes = (frame_count + key_interval - 1) / key_interval;
+	uint32_t size = MAXDELTA_HEADER_SIZE + keyframes * 2;
+
+	//header and index have to fit before anything is written
+	if (output && size > max_size)
+		return 0;
+
+	for (uint16_t frame = 0; frame < frame_count; frame++)
+	{
+		const uint8_t* rows = frames + frame * MATRIX_DIM;
+		bool keyframe = frame % key_interval == 0;
+
+		//keyframe index entry
+		if (keyframe && output)
+		{
+			uint16_t index = MAXDELTA_HEADER_SIZE + (frame / key_interval) * 2;
+			output[index] = size & 0xFF;
+			output[index + 1] = size >> 8;
+		}
+
+		//row mask, then the rows it lists
+		uint8_t mask = 0;
+		uint32_t mask_offset = size++;
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+		{
+			uint8_t data = keyframe ? rows[i] : rows[i] ^ rows[i - MATRIX_DIM];
+			if (!data)
+				continue;
+
+			mask |= 1 << i;
+			if (output && size < max_size)
+				output[size] = data;
+			size++;
+		}
+
+		if (output && mask_offset < max_size)
+			output[mask_offset] = mask;
+	}
+
+	//offsets are 16 bit
+	if (size > 0xFFFF || (output && size > max_size))
+		return 0;
+
+	if (output)
+	{
+		output[0] = frame_count & 0xFF;
+		output[1] = frame_count >> 8;
+		output[2] = key_interval;
+		output[3] = MAXDELTA_VERSION;
+	}
+
+	return size;
+}
+
+MAXSprite_Delta::MAXSprite_Delta(const uint8_t* data, uint8_t width, uint8_t height, bool progmem, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
+{
+	initAnimation(data, width, height, progmem, position_x, position_y, position_constraints, show);
+}
+
+bool MAXSprite_Delta::initAnimation(const uint8_t* data, uint8_t width, uint8_t height, bool progmem, int position_x /*= 0*/, int position_y /*= 0*/, uint8_t position_constraints /*= NoEdges*/, bool show /*= true*/)
+{
+	Data = data;
+	DataProgmem = progmem;
+	memset(FrameRows, 0x00, MATRIX_DIM);
+
+	//blank sprite unless the header checks out
+	FrameCount = 0;
+	if (data && readByte(3) == MAXDELTA_VERSION && readByte(2))
+	{
+		FrameCount = readByte(0) | (readByte(1) << 8);
+		KeyInterval = readByte(2);
+	}
+
+	//sprite reads the decoded frame in place
+	setSource(FrameRows);
+	initProperties(width, height, position_x, position_y, position_constraints, show);
+
+	if (!FrameCount)
+		return false;
+
+	//frame after CurrentFrame is decoded from scratch
+	CurrentFrame = FrameCount;
+	return loadFrame(0);
+}
+
+MAXSprite_Delta& MAXSprite_Delta::operator=(const MAXSprite_Delta& other)
+{
+	if (this == &other)
+		return *this;
+
+	MAXSprite_Animated::operator=(other);
+
+	Data = other.Data;
+	DataProgmem = other.DataProgmem;
+	KeyInterval = other.KeyInterval;
+	memcpy(FrameRows, other.FrameRows, MATRIX_DIM);
+	KeyPhase = other.KeyPhase;
+	NextRecord = other.NextRecord;
+
+	//inherited source still points at the other sprite's frame buffer
+	setSource(FrameRows);
+
+	return *this;
+}
+
+uint16_t MAXSprite_Delta::decodeRecord(uint16_t offset, bool keyframe)
+{
+	uint8_t mask = readByte(offset++);
+
+	//keyframes list only their non-zero rows
+	if (keyframe)
+		memset(FrameRows, 0x00, MATRIX_DIM);
+
+	//rows that follow, both record types XOR into the frame
+	for (uint8_t* row = FrameRows; mask; mask >>= 1, row++)
+		if (mask & 0x01)
+			*row ^= readByte(offset++);
+
+	return offset;
+}
+
+bool MAXSprite_Delta::loadFrame(uint16_t frame)
+{
+	if (frame >= FrameCount)
+		return false;
+
+	//already there
+	if (frame == CurrentFrame)
+		return true;
+
+	if (frame == CurrentFrame + 1)
+	{
+		//next record follows on (keyframe or not), no seek
+		CurrentFrame++;
+		KeyPhase = KeyPhase + 1 < KeyInterval ? KeyPhase + 1 : 0;
+		NextRecord = decodeRecord(NextRecord, !KeyPhase);
+	}
+	else
+	{
+		//carry on from the current frame when the target is ahead of it in the same keyframe interval,
+		//otherwise start over from the target's keyframe
+		uint16_t keyframe = frame / KeyInterval;
+		if (frame < CurrentFrame || CurrentFrame >= FrameCount || keyframe != CurrentFrame / KeyInterval)
+		{
+			uint16_t index = MAXDELTA_HEADER_SIZE + keyframe * 2;
+
+			CurrentFrame = keyframe * KeyInterval;
+			KeyPhase = 0;
+			NextRecord = decodeRecord(readByte(index) | (readByte(index + 1) << 8), true);
+		}
+
+		//deltas up to the target
+		for (; CurrentFrame < frame; CurrentFrame++, KeyPhase++)
+			NextRecord = decodeRecord(NextRecord, false);
+	}
+
+	//new data (cached again if the sprite is transformed)
+	setSource(FrameRows);
+
+	return true;
+}
@@ -0,0 +1,64 @@
+// MAXgfx_Delta.h
+
+#ifndef _MAX72XX_GFX_DELTA_h
+#define _MAX72XX_GFX_DELTA_h
+
+#include "MAXgfx.h"
+
+//format version stored in byte 3 of the header
+#define MAXDELTA_VERSION 1
+#define MAXDELTA_HEADER_SIZE 4
+
+/** Compressed animation format.
+ *  header:  frame count (2 bytes, little endian), keyframe interval (1 - 255), MAXDELTA_VERSION
+ *  index:   offset of every keyframe's record from the start of the data (2 bytes each, little endian)
+ *  records: one per frame in order, a row mask byte (bit i set = row i follows) then one byte per set bit.
+ *           Keyframes (every interval'th frame, from frame 0) list their non-zero rows, other frames list the
+ *           rows that changed as XOR against the previous frame, so an unchanged frame costs one byte. */
+namespace MAXDelta
+{
+	//encode frame_count frames of MATRIX_DIM bytes stored back to back, returns bytes written (0 if output is
+	//too small). output NULL returns the size only
+	uint16_t encode(const uint8_t* frames, uint16_t frame_count, uint8_t key_interval, uint8_t* output, uint16_t max_size);
+}
+
+/** Sprite playing a MAXDelta animation from RAM or flash.
+ *  Frames are decoded into one frame buffer the sprite reads in place, so RAM use doesn't depend on frame count
+ *  and stepping forward only touches the rows that changed. Seeking (loadFrame, reverse playback) decodes forward
+ *  from the nearest keyframe, at most key interval records. */
+class MAXSprite_Delta : public MAXSprite_Animated
+{
+
+protected:
+
+	//encoded animation
+	const uint8_t* Data = NULL;
+	bool DataProgmem = false;
+	uint8_t KeyInterval = 1;
+
+	//decoded current frame (CurrentFrame), its position in its keyframe interval and offset of the record of the frame after it
+	uint8_t FrameRows[MATRIX_DIM];
+	uint8_t KeyPhase = 0;
+	uint16_t NextRecord = 0;
+
+	uint8_t readByte(uint16_t offset) { return DataProgmem ? pgm_read_byte(Data + offset) : Data[offset]; }
+
+	//apply the record at offset to FrameRows, returns offset of the next record
+	uint16_t decodeRecord(uint16_t offset, bool keyframe);
+
+public:
+
+	MAXSprite_Delta() {}
+	//copies read their own frame buffer, not the original's
+	MAXSprite_Delta(const MAXSprite_Delta& other) { *this = other; }
+	MAXSprite_Delta& operator=(const MAXSprite_Delta& other);
+	MAXSprite_Delta(const uint8_t* data, uint8_t width, uint8_t height, bool progmem, int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true);
+
+	//returns false (and shows nothing) if data isn't a MAXDelta animation of this version
+	bool initAnimation(const uint8_t* data, uint8_t width, uint8_t height, bool progmem, int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true);
+
+	//seeks from the nearest keyframe, stepping forward (nextFrame) decodes one record
+	bool loadFrame(uint16_t frame);
+};
+
+#endif
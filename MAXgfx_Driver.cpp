@@ -0,0 +1,129 @@
+//
+//
+//
+
+#include "MAXgfx_Driver.h"
+
+#if defined(ARDUINO)
+
+void MAXDriver_SPI::begin(uint8_t device_count)
+{
+	//every device shares the one load pin, the count only matters to the simulator
+	(void)device_count;
+
+	pinMode(LoadPin, OUTPUT);
+	digitalWrite(LoadPin, HIGH);
+	SPI.begin();
+}
+
+#else
+
+#include <string.h>
+
+void MAXDriver_Sim::begin(uint8_t device_count)
+{
+	DeviceCount = device_count < MAXGFX_SIM_MAX_DEVICES ? device_count : MAXGFX_SIM_MAX_DEVICES;
+
+	//power-on state: everything cleared, shut down
+	memset(Registers, 0x00, sizeof(Registers));
+	PendingCount = 0;
+}
+
+void MAXDriver_Sim::write(uint8_t reg, uint8_t data)
+{
+	//words beyond the chain length fall out of the last device, keep the most recent ones
+	if (PendingCount < MAXGFX_SIM_MAX_DEVICES)
+	{
+		PendingRegister[PendingCount] = reg;
+		PendingData[PendingCount] = data;
+	}
+	else
+	{
+		memmove(PendingRegister, PendingRegister + 1, MAXGFX_SIM_MAX_DEVICES - 1);
+		memmove(PendingData, PendingData + 1, MAXGFX_SIM_MAX_DEVICES - 1);
+		PendingRegister[MAXGFX_SIM_MAX_DEVICES - 1] = reg;
+		PendingData[MAXGFX_SIM_MAX_DEVICES - 1] = data;
+	}
+	PendingCount++;
+
+	BytesWritten += 2;
+	FrameBytes += 2;
+	BusTimeNs += 16ULL * 1000000000ULL / ClockHz;
+}
+
+void MAXDriver_Sim::endWrite()
+{
+	uint8_t stored = PendingCount < MAXGFX_SIM_MAX_DEVICES ? PendingCount : MAXGFX_SIM_MAX_DEVICES;
+
+	//last word shifted in is held by device 0, the one before by device 1, ...
+	for (uint8_t device = 0; device < DeviceCount && device < stored; device++)
+	{
+		uint8_t reg = PendingRegister[stored - 1 - device] & 0x0F;
+
+		//no-op register leaves the device unchanged
+		if (reg)
+		{
+			Registers[device][reg] = PendingData[stored - 1 - device];
+			RegisterWrites++;
+		}
+	}
+
+	PendingCount = 0;
+	Transactions++;
+	BusTimeNs += LoadOverheadNs;
+}
+
+void MAXDriver_Sim::endFrame()
+{
+	Frames++;
+	LastFrameBytes = FrameBytes;
+	if (FrameBytes > MaxFrameBytes)
+		MaxFrameBytes = FrameBytes;
+	FrameBytes = 0;
+
+	LastFrameNs = BusTimeNs - FrameStartNs;
+	FrameStartNs = BusTimeNs;
+}
+
+void MAXDriver_Sim::resetCounters()
+{
+	Transactions = 0;
+	RegisterWrites = 0;
+	BytesWritten = 0;
+	BusTimeNs = 0;
+	Frames = 0;
+	FrameBytes = 0;
+	LastFrameBytes = 0;
+	MaxFrameBytes = 0;
+	FrameStartNs = 0;
+	LastFrameNs = 0;
+}
+
+bool MAXDriver_Sim::getPixel(uint8_t module_cols, int x, int y)
+{
+	if (x < 0 || y < 0 || !module_cols)
+		return false;
+
+	uint8_t device = (y / 8) * module_cols + x / 8;
+	if (x / 8 >= module_cols || device >= DeviceCount)
+		return false;
+
+	return getRow(device, y % 8) & (0x80 >> (x % 8));
+}
+
+void MAXDriver_Sim::print(FILE* file, uint8_t module_cols)
+{
+	if (!module_cols)
+		return;
+
+	uint8_t module_rows = (DeviceCount + module_cols - 1) / module_cols;
+
+	for (int y = 0; y < module_rows * 8; y++)
+	{
+		for (int x = 0; x < module_cols * 8; x++)
+			fputc(getPixel(module_cols, x, y) ? '#' : '.', file);
+		fputc('\n', file);
+	}
+}
+
+#endif
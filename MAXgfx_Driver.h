@@ -0,0 +1,139 @@
+// MAXgfx_Driver.h
+
+#ifndef _MAX72XX_GFX_DRIVER_h
+#define _MAX72XX_GFX_DRIVER_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+	#include <SPI.h>
+#elif defined(ARDUINO)
+	#include "WProgram.h"
+	#include <SPI.h>
+#else
+	#include <stdint.h>
+	#include <stdio.h>
+#endif
+
+/** Output stage for a chain of MAX72XX devices sharing one LOAD line.
+ *  A write is one LOAD cycle: beginWrite(), one write() per device starting with the last device
+ *  in the chain, then endWrite() latches every device at once. */
+class MAXDriver
+{
+public:
+
+	virtual ~MAXDriver() {}
+
+	//prepare the bus for a chain of device_count devices
+	virtual void begin(uint8_t device_count) = 0;
+
+	//LOAD cycle
+	virtual void beginWrite() = 0;
+	virtual void write(uint8_t reg, uint8_t data) = 0;
+	virtual void endWrite() = 0;
+
+	//called once a full display refresh has been sent
+	virtual void endFrame() {}
+
+	//queued (interrupt/DMA) drivers return true while earlier writes are still going out,
+	//incremental refreshes wait for the driver before sending more rows
+	virtual bool isBusy() { return false; }
+};
+
+#if defined(ARDUINO)
+
+/** Hardware SPI (MOSI/SCK) with a user defined LOAD (CS) pin */
+class MAXDriver_SPI : public MAXDriver
+{
+protected:
+
+	int LoadPin;
+
+public:
+
+	MAXDriver_SPI(int load_pin = -1) : LoadPin(load_pin) {}
+
+	void begin(uint8_t device_count);
+
+	//MAX72XX: 10MHz max, MSB first, data sampled on rising edge
+	void beginWrite() { SPI.beginTransaction(SPISettings(10000000, MSBFIRST, SPI_MODE0)); digitalWrite(LoadPin, LOW); }
+	void write(uint8_t reg, uint8_t data) { SPI.transfer(reg); SPI.transfer(data); }
+	void endWrite() { digitalWrite(LoadPin, HIGH); SPI.endTransaction(); }
+};
+
+#else
+
+#define MAXGFX_SIM_MAX_DEVICES 64
+
+/** Simulated chain for host builds.
+ *  Keeps the register file of every device and counts bus traffic, with bus time
+ *  estimated from a configurable SPI clock (16 bits per device per LOAD cycle). */
+class MAXDriver_Sim : public MAXDriver
+{
+protected:
+
+	uint8_t DeviceCount = 0;
+
+	//register file, 16 registers per device (digits are 0x01 - 0x08)
+	uint8_t Registers[MAXGFX_SIM_MAX_DEVICES][16];
+
+	//words shifted in during the current LOAD cycle, last word ends up in device 0
+	uint8_t PendingRegister[MAXGFX_SIM_MAX_DEVICES];
+	uint8_t PendingData[MAXGFX_SIM_MAX_DEVICES];
+	uint16_t PendingCount = 0;
+
+	//bus settings
+	uint32_t ClockHz;
+	uint32_t LoadOverheadNs;
+
+	//traffic counters
+	uint32_t Transactions = 0;
+	uint32_t RegisterWrites = 0;
+	uint32_t BytesWritten = 0;
+	uint64_t BusTimeNs = 0;
+
+	//per-frame counters
+	uint32_t Frames = 0;
+	uint32_t FrameBytes = 0;
+	uint32_t LastFrameBytes = 0;
+	uint32_t MaxFrameBytes = 0;
+	uint64_t FrameStartNs = 0;
+	uint64_t LastFrameNs = 0;
+
+public:
+
+	MAXDriver_Sim(uint32_t clock_hz = 10000000, uint32_t load_overhead_ns = 0) : ClockHz(clock_hz), LoadOverheadNs(load_overhead_ns) {}
+
+	void begin(uint8_t device_count);
+	void beginWrite() { PendingCount = 0; }
+	void write(uint8_t reg, uint8_t data);
+	void endWrite();
+	void endFrame();
+
+	//bus settings
+	void setClock(uint32_t clock_hz) { ClockHz = clock_hz; }
+	void setLoadOverhead(uint32_t load_overhead_ns) { LoadOverheadNs = load_overhead_ns; }
+
+	//device state
+	uint8_t getDeviceCount() { return DeviceCount; }
+	uint8_t getRegister(uint8_t device, uint8_t reg) { return device < DeviceCount ? Registers[device][reg & 0x0F] : 0x00; }
+	uint8_t getRow(uint8_t device, uint8_t row) { return getRegister(device, 0x01 + row); }
+	bool getPixel(uint8_t module_cols, int x, int y);
+
+	//traffic getters
+	uint32_t getTransactions() { return Transactions; }
+	uint32_t getRegisterWrites() { return RegisterWrites; }
+	uint32_t getBytesWritten() { return BytesWritten; }
+	uint64_t getBusTimeNs() { return BusTimeNs; }
+	uint32_t getFrames() { return Frames; }
+	uint32_t getLastFrameBytes() { return LastFrameBytes; }
+	uint32_t getMaxFrameBytes() { return MaxFrameBytes; }
+	uint64_t getLastFrameNs() { return LastFrameNs; }
+	void resetCounters();
+
+	//print display contents, module_cols modules per line of modules
+	void print(FILE* file, uint8_t module_cols = 1);
+};
+
+#endif
+
+#endif
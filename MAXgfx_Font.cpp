@@ -0,0 +1,305 @@
+//
+//
+//
+
+#include "MAXgfx_Font.h"
+
+// unnamed namespace for static data
+namespace
+{
+	//5x7 glyphs, 0x20 - 0x7E, 5 columns each (bit 0 = top row)
+	const uint8_t Font5x7Glyphs[] PROGMEM =
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+		0x00, 0x00, 0x5F, 0x00, 0x00,	// !
+		0x00, 0x07, 0x00, 0x07, 0x00,	// "
+		0x14, 0x7F, 0x14, 0x7F, 0x14,	// #
+		0x24, 0x2A, 0x7F, 0x2A, 0x12,	// $
+		0x23, 0x13, 0x08, 0x64, 0x62,	// %
+		0x36, 0x49, 0x55, 0x22, 0x50,	// &
+		0x00, 0x05, 0x03, 0x00, 0x00,	// '
+		0x00, 0x1C, 0x22, 0x41, 0x00,	// (
+		0x00, 0x41, 0x22, 0x1C, 0x00,	// )
+		0x08, 0x2A, 0x1C, 0x2A, 0x08,	// *
+		0x08, 0x08, 0x3E, 0x08, 0x08,	// +
+		0x00, 0x50, 0x30, 0x00, 0x00,	// ,
+		0x08, 0x08, 0x08, 0x08, 0x08,	// -
+		0x00, 0x60, 0x60, 0x00, 0x00,	// .
+		0x20, 0x10, 0x08, 0x04, 0x02,	// /
+		0x3E, 0x51, 0x49, 0x45, 0x3E,	// 0
+		0x00, 0x42, 0x7F, 0x40, 0x00,	// 1
+		0x42, 0x61, 0x51, 0x49, 0x46,	// 2
+		0x21, 0x41, 0x45, 0x4B, 0x31,	// 3
+		0x18, 0x14, 0x12, 0x7F, 0x10,	// 4
+		0x27, 0x45, 0x45, 0x45, 0x39,	// 5
+		0x3C, 0x4A, 0x49, 0x49, 0x30,	// 6
+		0x01, 0x71, 0x09, 0x05, 0x03,	// 7
+		0x36, 0x49, 0x49, 0x49, 0x36,	// 8
+		0x06, 0x49, 0x49, 0x29, 0x1E,	// 9
+		0x00, 0x36, 0x36, 0x00, 0x00,	// :
+		0x00, 0x56, 0x36, 0x00, 0x00,	// ;
+		0x08, 0x14, 0x22, 0x41, 0x00,	// <
+		0x14, 0x14, 0x14, 0x14, 0x14,	// =
+		0x00, 0x41, 0x22, 0x14, 0x08,	// >
+		0x02, 0x01, 0x51, 0x09, 0x06,	// ?
+		0x32, 0x49, 0x79, 0x41, 0x3E,	// @
+		0x7E, 0x11, 0x11, 0x11, 0x7E,	// A
+		0x7F, 0x49, 0x49, 0x49, 0x36,	// B
+		0x3E, 0x41, 0x41, 0x41, 0x22,	// C
+		0x7F, 0x41, 0x41, 0x22, 0x1C,	// D
+		0x7F, 0x49, 0x49, 0x49, 0x41,	// E
+		0x7F, 0x09, 0x09, 0x09, 0x01,	// F
+		0x3E, 0x41, 0x49, 0x49, 0x7A,	// G
+		0x7F, 0x08, 0x08, 0x08, 0x7F,	// H
+		0x00, 0x41, 0x7F, 0x41, 0x00,	// I
+		0x20, 0x40, 0x41, 0x3F, 0x01,	// J
+		0x7F, 0x08, 0x14, 0x22, 0x41,	// K
+		0x7F, 0x40, 0x40, 0x40, 0x40,	// L
+		0x7F, 0x02, 0x0C, 0x02, 0x7F,	// M
+		0x7F, 0x04, 0x08, 0x10, 0x7F,	// N
+		0x3E, 0x41, 0x41, 0x41, 0x3E,	// O
+		0x7F, 0x09, 0x09, 0x09, 0x06,	// P
+		0x3E, 0x41, 0x51, 0x21, 0x5E,	// Q
+		0x7F, 0x09, 0x19, 0x29, 0x46,	// R
+		0x46, 0x49, 0x49, 0x49, 0x31,	// S
+		0x01, 0x01, 0x7F, 0x01, 0x01,	// T
+		0x3F, 0x40, 0x40, 0x40, 0x3F,	// U
+		0x1F, 0x20, 0x40, 0x20, 0x1F,	// V
+		0x3F, 0x40, 0x38, 0x40, 0x3F,	// W
+		0x63, 0x14, 0x08, 0x14, 0x63,	// X
+		0x07, 0x08, 0x70, 0x08, 0x07,	// Y
+		0x61, 0x51, 0x49, 0x45, 0x43,	// Z
+		0x00, 0x7F, 0x41, 0x41, 0x00,	// [
+		0x02, 0x04, 0x08, 0x10, 0x20,	// backslash
+		0x00, 0x41, 0x41, 0x7F, 0x00,	// ]
+		0x04, 0x02, 0x01, 0x02, 0x04,	// ^
+		0x40, 0x40, 0x40, 0x40, 0x40,	// _
+		0x00, 0x01, 0x02, 0x04, 0x00,	// `
+		0x20, 0x54, 0x54, 0x54, 0x78,	// a
+		0x7F, 0x48, 0x44, 0x44, 0x38,	// b
+		0x38, 0x44, 0x44, 0x44, 0x20,	// c
+		0x38, 0x44, 0x44, 0x48, 0x7F,	// d
+		0x38, 0x54, 0x54, 0x54, 0x18,	// e
+		0x08, 0x7E, 0x09, 0x01, 0x02,	// f
+		0x0C, 0x52, 0x52, 0x52, 0x3E,	// g
+		0x7F, 0x08, 0x04, 0x04, 0x78,	// h
+		0x00, 0x44, 0x7D, 0x40, 0x00,	// i
+		0x20, 0x40, 0x44, 0x3D, 0x00,	// j
+		0x7F, 0x10, 0x28, 0x44, 0x00,	// k
+		0x00, 0x41, 0x7F, 0x40, 0x00,	// l
+		0x7C, 0x04, 0x18, 0x04, 0x78,	// m
+		0x7C, 0x08, 0x04, 0x04, 0x78,	// n
+		0x38, 0x44, 0x44, 0x44, 0x38,	// o
+		0x7C, 0x14, 0x14, 0x14, 0x08,	// p
+		0x08, 0x14, 0x14, 0x18, 0x7C,	// q
+		0x7C, 0x08, 0x04, 0x04, 0x08,	// r
+		0x48, 0x54, 0x54, 0x54, 0x20,	// s
+		0x04, 0x3F, 0x44, 0x40, 0x20,	// t
+		0x3C, 0x40, 0x40, 0x20, 0x7C,	// u
+		0x1C, 0x20, 0x40, 0x20, 0x1C,	// v
+		0x3C, 0x40, 0x30, 0x40, 0x3C,	// w
+		0x44, 0x28, 0x10, 0x28, 0x44,	// x
+		0x0C, 0x50, 0x50, 0x50, 0x3C,	// y
+		0x44, 0x64, 0x54, 0x4C, 0x44,	// z
+		0x00, 0x08, 0x36, 0x41, 0x00,	// {
+		0x00, 0x00, 0x7F, 0x00, 0x00,	// |
+		0x00, 0x41, 0x36, 0x08, 0x00,	// }
+		0x08, 0x04, 0x08, 0x10, 0x08,	// ~
+	};
+
+	//width of a space in proportional text
+	const uint8_t PROPORTIONAL_SPACE = 3;
+}
+
+const MAXFont MAXFont_5x7 = { Font5x7Glyphs, 0x20, 0x7E, 5, 7 };
+
+uint8_t MAXText::getColumn(const MAXFont& font, char c, uint8_t column)
+{
+	if ((uint8_t)c < font.FirstChar || (uint8_t)c > font.LastChar || column >= font.Width)
+		return 0x00;
+
+	return pgm_read_byte(font.Glyphs + ((uint8_t)c - font.FirstChar) * font.Width + column);
+}
+
+bool MAXText::getInkColumns(const MAXFont& font, char c, uint8_t& first, uint8_t& last)
+{
+	first = 0;
+	while (first < font.Width && !getColumn(font, c, first))
+		first++;
+
+	//blank glyph
+	if (first == font.Width)
+		return false;
+
+	last = font.Width - 1;
+	while (!getColumn(font, c, last))
+		last--;
+
+	return true;
+}
+
+int MAXText::drawText(MAXBitmap& target, const MAXFont& font, int x, int y, const char* text, bool progmem /*= false*/, uint8_t spacing /*= 1*/, uint8_t blend /*= BlendOr*/)
+{
+	int start_x = x;
+
+	for (uint16_t i = 0; char c = readChar(text, i, progmem); i++)
+	{
+		if (i)
+			x += spacing;
+
+		//stop once past right edge
+		if (x >= (int)target.getWidth())
+			break;
+
+		for (uint8_t column = 0; column < font.Width; column++, x++)
+		{
+			uint8_t bits = getColumn(font, c, column);
+
+			for (uint8_t row = 0; row < font.Height; row++)
+			{
+				bool on = bits & (1 << row);
+				if (blend == BlendOpaque)
+					target.setPixel(x, y + row, on);
+				else if (on)
+					target.setPixel(x, y + row, blend == BlendXor ? !target.getPixel(x, y + row) : blend != BlendErase);
+			}
+		}
+	}
+
+	return x - start_x;
+}
+
+uint8_t MAXText::getCharWidth(const MAXFont& font, char c, bool proportional)
+{
+	if (!proportional)
+		return font.Width;
+
+	//blank glyphs are a fixed width space
+	uint8_t first, last;
+	return getInkColumns(font, c, first, last) ? last - first + 1 : PROPORTIONAL_SPACE;
+}
+
+int MAXText::getTextWidth(const MAXFont& font, const char* text, bool progmem /*= false*/, uint8_t spacing /*= 1*/, bool proportional /*= false*/)
+{
+	int width = 0;
+	uint16_t length = 0;
+	for (; char c = readChar(text, length, progmem); length++)
+		width += getCharWidth(font, c, proportional) + spacing;
+
+	return length ? width - spacing : 0;
+}
+
+MAXMarquee_Base::MAXMarquee_Base(uint8_t* ring_data, uint16_t width) :
+	Ring(ring_data, 2 * width, 8), Width(width), Font(&MAXFont_5x7), LoopGap(width)
+{
+}
+
+void MAXMarquee_Base::setText(const char* text, bool progmem /*= false*/)
+{
+	Text = text;
+	TextProgmem = progmem;
+	TextIndex = 0;
+
+	//start with the first character
+	GlyphColumn = 1;
+	GlyphLastColumn = 0;
+	BlankColumns = 0;
+	Finished = !text;
+}
+
+bool MAXMarquee_Base::loadCharacter()
+{
+	Character = MAXText::readChar(Text, TextIndex, TextProgmem);
+	if (!Character)
+		return false;
+	TextIndex++;
+
+	//whole cell for fixed width or blank glyphs, trimmed to ink for proportional
+	GlyphColumn = 0;
+	GlyphLastColumn = Font->Width - 1;
+	if (Proportional && !MAXText::getInkColumns(*Font, Character, GlyphColumn, GlyphLastColumn))
+	{
+		GlyphColumn = 0;
+		GlyphLastColumn = PROPORTIONAL_SPACE - 1;
+	}
+
+	return true;
+}
+
+uint8_t MAXMarquee_Base::nextColumn()
+{
+	//spacing between characters, gap between loops
+	if (BlankColumns)
+	{
+		BlankColumns--;
+		return 0x00;
+	}
+
+	if (Finished)
+		return 0x00;
+
+	//current character done, move to next
+	if (GlyphColumn > GlyphLastColumn && !loadCharacter())
+	{
+		if (!Loop)
+		{
+			Finished = true;
+			return 0x00;
+		}
+
+		//start again after the gap (or straight away if there's no gap)
+		TextIndex = 0;
+		if (LoopGap)
+		{
+			BlankColumns = LoopGap - 1;
+			return 0x00;
+		}
+		if (!loadCharacter())
+			return 0x00;
+	}
+
+	uint8_t column = MAXText::getColumn(*Font, Character, GlyphColumn++);
+
+	//end of character, add spacing
+	if (GlyphColumn > GlyphLastColumn)
+		BlankColumns = Spacing;
+
+	return column;
+}
+
+bool MAXMarquee_Base::step()
+{
+	uint8_t column = nextColumn();
+
+	//write the new column at Head and Head + Width (bit i of column = row i)
+	uint8_t bit = 0x80 >> (Head & 0x07);
+	uint8_t* data = Ring.getRow(0) + (Head >> 3);
+	uint8_t* copy = Ring.getRow(0) + ((Head + Width) >> 3);
+	uint8_t copy_bit = 0x80 >> ((Head + Width) & 0x07);
+
+	for (uint8_t i = 0; i < 8; i++, data += Ring.getStride(), copy += Ring.getStride())
+	{
+		if (column & (1 << i))
+		{
+			*data |= bit;
+			*copy |= copy_bit;
+		}
+		else
+		{
+			*data &= ~bit;
+			*copy &= ~copy_bit;
+		}
+	}
+
+	//oldest column is now the one after the new one
+	if (++Head == Width)
+		Head = 0;
+
+	return !Finished;
+}
+
+void MAXMarquee_Base::draw(MAXBitmap& frame, uint8_t blend)
+{
+	//window is always contiguous: Head (oldest column) to Head + Width
+	frame.blit(Ring, Head, 0, Width, 8, PositionX, PositionY, blend);
+}
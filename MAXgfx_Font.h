@@ -0,0 +1,133 @@
+// MAXgfx_Font.h
+
+#ifndef _MAX72XX_GFX_FONT_h
+#define _MAX72XX_GFX_FONT_h
+
+#include "MAXgfx.h"
+
+/** Bitmap font stored as glyph columns (one byte per column, bit 0 = top row), glyphs back to back in flash */
+struct MAXFont
+{
+	const uint8_t* Glyphs;
+
+	//characters in table
+	uint8_t FirstChar;
+	uint8_t LastChar;
+
+	//glyph cell size
+	uint8_t Width;
+	uint8_t Height;
+};
+
+//5x7 ASCII font (0x20 - 0x7E)
+extern const MAXFont MAXFont_5x7;
+
+namespace MAXText
+{
+	//read character index of text from RAM or flash
+	inline char readChar(const char* text, uint16_t index, bool progmem) { return progmem ? (char)pgm_read_byte(text + index) : text[index]; }
+
+	//glyph column of a character (0 for characters not in the font)
+	uint8_t getColumn(const MAXFont& font, char c, uint8_t column);
+
+	//first and last non-empty column of a glyph, for proportional spacing (returns false for blank glyphs)
+	bool getInkColumns(const MAXFont& font, char c, uint8_t& first, uint8_t& last);
+
+	//draw text into a bitmap with its top left corner at x, y, returns width drawn in pixels
+	int drawText(MAXBitmap& target, const MAXFont& font, int x, int y, const char* text, bool progmem = false, uint8_t spacing = 1, uint8_t blend = BlendOr);
+	//width of text in pixels, proportional measures each glyph's ink (as MAXMarquee does when set proportional)
+	int getTextWidth(const MAXFont& font, const char* text, bool progmem = false, uint8_t spacing = 1, bool proportional = false);
+
+	//width of one character, trimmed to its ink for proportional text
+	uint8_t getCharWidth(const MAXFont& font, char c, bool proportional);
+}
+
+/** Scrolling text (marquee), drawn as a display layer.
+ *  The visible window is a ring of columns stored twice side by side in a row-major bitmap, so shifting in
+ *  a new column writes one bit per text row and the window is always a contiguous region to blit. */
+class MAXMarquee_Base : public MAXDrawable
+{
+
+protected:
+
+	//ring storage, 2 x Width columns by 8 rows
+	MAXBitmap Ring;
+	uint16_t Width;
+
+	//column the next step writes to (oldest visible column)
+	uint16_t Head = 0;
+
+	//text being scrolled
+	const MAXFont* Font;
+	const char* Text = NULL;
+	bool TextProgmem = false;
+	uint16_t TextIndex = 0;
+	char Character = 0;
+
+	//column within current character, last column to output for it, blank columns still to output
+	uint8_t GlyphColumn = 0;
+	uint8_t GlyphLastColumn = 0;
+	uint16_t BlankColumns = 0;
+
+	//settings
+	uint8_t Spacing = 1;
+	uint16_t LoopGap;
+	bool Loop = true;
+	bool Proportional = true;
+	bool Finished = true;
+
+	//position of the window on the display
+	int PositionX = 0;
+	int PositionY = 0;
+
+	MAXMarquee_Base(uint8_t* ring_data, uint16_t width);
+
+	//load columns of the character at TextIndex, returns false at end of text
+	bool loadCharacter();
+
+	//next column of text to shift in
+	uint8_t nextColumn();
+
+public:
+
+	void setText(const char* text, bool progmem = false);
+	void setText_P(const char* text) { setText(text, true); }
+
+	//settings
+	void setFont(const MAXFont& font) { Font = &font; }
+	void setSpacing(uint8_t spacing) { Spacing = spacing; }
+	void setLoop(bool loop, uint16_t gap_columns) { Loop = loop; LoopGap = gap_columns; }
+	void setProportional(bool proportional) { Proportional = proportional; }
+
+	//width of the current text with the marquee's font, spacing and proportional setting
+	int getTextWidth() { return Text ? MAXText::getTextWidth(*Font, Text, TextProgmem, Spacing, Proportional) : 0; }
+
+	//window position on the display
+	void setPosition(int position_x, int position_y) { PositionX = position_x; PositionY = position_y; }
+
+	//clear the window
+	void clear() { Ring.clear(); Head = 0; }
+
+	//shift in one column, returns false once the text has scrolled in completely (never when looping)
+	bool step();
+	bool isFinished() { return Finished; }
+
+	void draw(MAXBitmap& frame, uint8_t blend);
+};
+
+/** Marquee with a window WIDTH columns wide (usually the display width) */
+template <uint16_t WIDTH>
+class MAXMarquee : public MAXMarquee_Base
+{
+
+protected:
+
+	uint8_t RingData[((2 * WIDTH + 7) / 8) * 8];
+
+public:
+
+	MAXMarquee() : MAXMarquee_Base(RingData, WIDTH), RingData() {}
+	MAXMarquee(const char* text, bool progmem = false) : MAXMarquee_Base(RingData, WIDTH), RingData() { setText(text, progmem); }
+};
+
+#endif
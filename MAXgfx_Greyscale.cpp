@@ -0,0 +1,87 @@
+//
+//
+//
+
+#include "MAXgfx_Greyscale.h"
+
+MAXGreyscale_Base::MAXGreyscale_Base(uint8_t* plane_data, uint16_t width, uint16_t height, uint8_t planes) :
+	PlaneData(plane_data), Width(width), Height(height), Planes(planes)
+{
+}
+
+void MAXGreyscale_Base::setPixel(int x, int y, uint8_t level)
+{
+	if (level > getMaxLevel())
+		level = getMaxLevel();
+
+	for (uint8_t plane = 0; plane < Planes; plane++)
+		getPlane(plane).setPixel(x, y, level & (1 << plane));
+}
+
+uint8_t MAXGreyscale_Base::getPixel(int x, int y)
+{
+	uint8_t level = 0;
+	for (uint8_t plane = 0; plane < Planes; plane++)
+		if (getPlane(plane).getPixel(x, y))
+			level |= 1 << plane;
+
+	return level;
+}
+
+void MAXGreyscale_Base::fillRect(int x, int y, int width, int height, uint8_t level)
+{
+	if (level > getMaxLevel())
+		level = getMaxLevel();
+
+	for (uint8_t plane = 0; plane < Planes; plane++)
+		getPlane(plane).fillRect(x, y, width, height, level & (1 << plane));
+}
+
+void MAXGreyscale_Base::nextSubframe(uint32_t now_us)
+{
+	//ruler sequence: subframe i shows plane (Planes - 1 - trailing zeros of i)
+	if (++Subframe > getSubframesPerCycle())
+		Subframe = 1;
+
+	uint8_t zeros = 0;
+	while (!(Subframe & (1 << zeros)))
+		zeros++;
+	CurrentPlane = Planes - 1 - zeros;
+
+	//timing
+	if (Subframes)
+	{
+		uint32_t interval = now_us - LastSubframeUs;
+		if (interval > MaxSubframeUs)
+			MaxSubframeUs = interval;
+	}
+	else
+		FirstSubframeUs = now_us;
+
+	LastSubframeUs = now_us;
+	Subframes++;
+}
+
+uint32_t MAXGreyscale_Base::getSubframeRate()
+{
+	uint32_t elapsed = LastSubframeUs - FirstSubframeUs;
+	if (Subframes < 2 || !elapsed)
+		return 0;
+
+	return (uint32_t)((uint64_t)(Subframes - 1) * 1000000UL / elapsed);
+}
+
+uint32_t MAXGreyscale_Base::getMinCycleRate()
+{
+	if (!MaxSubframeUs)
+		return 0;
+
+	//a subframe is on the display for at least one digit scan however fast it was sent
+	uint32_t subframe_us = MaxSubframeUs > 1000000UL / MAXGFX_SCAN_HZ ? MaxSubframeUs : 1000000UL / MAXGFX_SCAN_HZ;
+	return 1000000UL / (subframe_us * getSubframesPerCycle());
+}
+
+void MAXGreyscale_Base::draw(MAXBitmap& frame, uint8_t blend)
+{
+	frame.blit(getPlane(CurrentPlane), PositionX, PositionY, blend);
+}
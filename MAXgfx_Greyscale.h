@@ -0,0 +1,105 @@
+// MAXgfx_Greyscale.h
+
+#ifndef _MAX72XX_GFX_GREYSCALE_h
+#define _MAX72XX_GFX_GREYSCALE_h
+
+#include "MAXgfx.h"
+
+//refresh rate of a full greyscale cycle below which flicker becomes visible
+#ifndef MAXGFX_FLICKER_HZ
+	#define MAXGFX_FLICKER_HZ 100
+#endif
+
+//digit multiplex rate of the MAX72XX, subframes are never seen faster than this
+#ifndef MAXGFX_SCAN_HZ
+	#define MAXGFX_SCAN_HZ 800
+#endif
+
+/** Greyscale layer by temporal dithering: pixel levels are stored as bit planes and every display refresh
+ *  (subframe) shows one plane. Plane k is shown in 2^k of the (2^Planes - 1) subframes of a cycle, spread out
+ *  in ruler order (MSB plane every other subframe) so each level's on-time is as even as possible.
+ *  Add it as a layer, 1-bit sprites above it are drawn at full brightness on every subframe.
+ *  Each subframe is a normal updateDisplay(), so only rows that differ from the previous plane are sent.
+ *  The MAX72XX multiplexes its digits at roughly MAXGFX_SCAN_HZ (800Hz), subframes much shorter than one scan
+ *  (1.25ms) show unevenly across rows, so 2 planes (4 levels) at ~800 subframes/s (~270 cycles/s) is the practical
+ *  limit. Pace nextSubframe() to the scan rather than calling it as fast as the bus allows. */
+class MAXGreyscale_Base : public MAXDrawable
+{
+
+protected:
+
+	//planes stored back to back, plane 0 (least significant) first
+	uint8_t* PlaneData;
+	uint16_t Width;
+	uint16_t Height;
+	uint8_t Planes;
+
+	//position in cycle (1 - 2^Planes - 1) and plane shown
+	uint8_t Subframe = 0;
+	uint8_t CurrentPlane = 0;
+
+	//position of the layer on the display
+	int PositionX = 0;
+	int PositionY = 0;
+
+	//timing statistics
+	uint32_t Subframes = 0;
+	uint32_t FirstSubframeUs = 0;
+	uint32_t LastSubframeUs = 0;
+	uint32_t MaxSubframeUs = 0;
+
+	MAXGreyscale_Base(uint8_t* plane_data, uint16_t width, uint16_t height, uint8_t planes);
+
+	MAXBitmap getPlane(uint8_t plane) { return MAXBitmap(PlaneData + plane * MAXBitmap::getBufferSize(Width, Height), Width, Height); }
+
+public:
+
+	//brightness levels (2^Planes), 0 = off
+	uint8_t getLevels() { return 1 << Planes; }
+	uint8_t getMaxLevel() { return (1 << Planes) - 1; }
+	uint8_t getSubframesPerCycle() { return (1 << Planes) - 1; }
+
+	//pixel access, coordinates outside the layer are ignored, level is clamped to getMaxLevel()
+	void setPixel(int x, int y, uint8_t level);
+	uint8_t getPixel(int x, int y);
+	void fillRect(int x, int y, int width, int height, uint8_t level);
+	void clear() { memset(PlaneData, 0x00, Planes * MAXBitmap::getBufferSize(Width, Height)); }
+
+	//layer position on the display
+	void setPosition(int position_x, int position_y) { PositionX = position_x; PositionY = position_y; }
+
+	//advance to the next subframe, call once before each display update. now_us (micros()) feeds the statistics
+	void nextSubframe(uint32_t now_us);
+#if defined(ARDUINO)
+	void nextSubframe() { nextSubframe(micros()); }
+#endif
+
+	//statistics: subframes per second, full greyscale cycles per second (average and worst case from the longest
+	//subframe, no shorter than one digit scan) and flicker margin = worst case cycle rate over MAXGFX_FLICKER_HZ in
+	//percent (100 = at the threshold). isFasterThanScan() = subframes on average shorter than one scan, rows show unevenly
+	uint32_t getSubframeRate();
+	uint32_t getCycleRate() { return getSubframeRate() / getSubframesPerCycle(); }
+	uint32_t getMinCycleRate();
+	uint32_t getFlickerMargin() { return getMinCycleRate() * 100 / MAXGFX_FLICKER_HZ; }
+	bool isFasterThanScan() { return getSubframeRate() > MAXGFX_SCAN_HZ; }
+	void resetStats() { Subframes = 0; MaxSubframeUs = 0; }
+
+	void draw(MAXBitmap& frame, uint8_t blend);
+};
+
+/** Greyscale layer of WIDTH x HEIGHT pixels with 2^PLANES levels (PLANES 1 - 4) */
+template <uint16_t WIDTH, uint16_t HEIGHT, uint8_t PLANES = 2>
+class MAXGreyscale : public MAXGreyscale_Base
+{
+	static_assert(PLANES >= 1 && PLANES <= 4, "1 to 4 bit planes");
+
+protected:
+
+	uint8_t Data[PLANES * ((WIDTH + 7) / 8) * HEIGHT];
+
+public:
+
+	MAXGreyscale() : MAXGreyscale_Base(Data, WIDTH, HEIGHT, PLANES), Data() {}
+};
+
+#endif
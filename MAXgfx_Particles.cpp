@@ -0,0 +1,182 @@
+//
+//
+//
+
+#include "MAXgfx_Particles.h"
+
+// unnamed namespace for static functions
+namespace
+{
+	//batch loops over separate arrays in whole blocks of MAXPARTICLE_BLOCK (no remainder loop, so they vectorise
+	//at -O2 as well as -O3 on host)
+	uint16_t RoundToBlock(uint16_t count) { return (count + MAXPARTICLE_BLOCK - 1) & ~(MAXPARTICLE_BLOCK - 1); }
+
+	void AddArray(int16_t* MAXGFX_RESTRICT values, const int16_t* MAXGFX_RESTRICT add, uint16_t count)
+	{
+		count = RoundToBlock(count);
+		for (uint16_t i = 0; i < count; i++)
+			values[i] += add[i];
+	}
+
+	void AddConstant(int16_t* MAXGFX_RESTRICT values, int16_t add, uint16_t count)
+	{
+		count = RoundToBlock(count);
+		for (uint16_t i = 0; i < count; i++)
+			values[i] += add;
+	}
+
+	void AgeArray(uint8_t* MAXGFX_RESTRICT life, uint16_t count)
+	{
+		count = RoundToBlock(count);
+		for (uint16_t i = 0; i < count; i++)
+			life[i] -= life[i] != MAXPARTICLE_FOREVER;
+	}
+
+	//any value outside min to min + span (as unsigned offset from min, so values below min count too)
+	uint8_t AnyOutside(const int16_t* MAXGFX_RESTRICT values, int16_t min, uint16_t span, uint16_t count)
+	{
+		uint8_t outside = 0;
+		for (uint16_t i = 0; i < count; i++)
+			outside |= (uint16_t)(values[i] - min) >= span;
+		return outside;
+	}
+
+	uint8_t AnyZero(const uint8_t* MAXGFX_RESTRICT values, uint16_t count)
+	{
+		uint8_t zero = 0;
+		for (uint16_t i = 0; i < count; i++)
+			zero |= !values[i];
+		return zero;
+	}
+}
+
+MAXParticles_Base::MAXParticles_Base(int16_t* x, int16_t* y, int16_t* velocity_x, int16_t* velocity_y, uint8_t* life, uint16_t capacity) :
+	X(x), Y(y), VelocityX(velocity_x), VelocityY(velocity_y), Life(life), Capacity(capacity)
+{
+}
+
+uint16_t MAXParticles_Base::nextRandom()
+{
+	//xorshift, period 65535
+	Random ^= Random << 7;
+	Random ^= Random >> 9;
+	Random ^= Random << 8;
+	return Random;
+}
+
+bool MAXParticles_Base::emit(int x, int y, int16_t velocity_x, int16_t velocity_y, uint8_t life /*= MAXPARTICLE_FOREVER*/)
+{
+	if (Count == Capacity || !life)
+	{
+		Rejected++;
+		return false;
+	}
+
+	//next slot after the live particles
+	X[Count] = x * MAXPARTICLE_ONE;
+	Y[Count] = y * MAXPARTICLE_ONE;
+	VelocityX[Count] = velocity_x;
+	VelocityY[Count] = velocity_y;
+	Life[Count] = life;
+	Count++;
+
+	return true;
+}
+
+uint16_t MAXParticles_Base::emitBurst(int x, int y, uint16_t count, int16_t velocity_x, int16_t velocity_y, uint8_t spread_x, uint8_t spread_y, uint8_t life, uint8_t life_spread /*= 0*/)
+{
+	uint16_t emitted = 0;
+
+	for (; emitted < count; emitted++)
+	{
+		int16_t vx = velocity_x + (int16_t)(nextRandom() % (2 * spread_x + 1)) - spread_x;
+		int16_t vy = velocity_y + (int16_t)(nextRandom() % (2 * spread_y + 1)) - spread_y;
+
+		//life kept within 1 - 254 so a spread never makes a particle immortal or dead on arrival
+		int16_t particle_life = life;
+		if (life != MAXPARTICLE_FOREVER && life_spread)
+		{
+			particle_life += (int16_t)(nextRandom() % (2 * life_spread + 1)) - life_spread;
+			particle_life = particle_life < 1 ? 1 : (particle_life > 0xFE ? 0xFE : particle_life);
+		}
+
+		if (!emit(x, y, vx, vy, particle_life))
+			break;
+	}
+
+	return emitted;
+}
+
+void MAXParticles_Base::update()
+{
+	uint16_t count = Count;
+
+	//slots up to the end of the last block are updated too, park them where they can't die
+	for (uint16_t i = count; i < RoundToBlock(count); i++)
+	{
+		X[i] = Y[i] = 0;
+		VelocityX[i] = VelocityY[i] = 0;
+		Life[i] = MAXPARTICLE_FOREVER;
+	}
+
+	//integrate, one plain loop per field
+	AddArray(X, VelocityX, count);
+	AddArray(Y, VelocityY, count);
+	if (GravityX)
+		AddConstant(VelocityX, GravityX, count);
+	if (GravityY)
+		AddConstant(VelocityY, GravityY, count);
+	AgeArray(Life, count);
+
+	//bounds in fixed point, a particle is inside while its pixel is (offsets below the origin compare as large unsigned)
+	int16_t min_x = BoundsX * MAXPARTICLE_ONE;
+	int16_t min_y = BoundsY * MAXPARTICLE_ONE;
+	uint16_t span_x = BoundsWidth ? BoundsWidth << MAXPARTICLE_SHIFT : 0xFFFF;
+	uint16_t span_y = BoundsHeight ? BoundsHeight << MAXPARTICLE_SHIFT : 0xFFFF;
+
+	//most steps nothing dies, find out in loops that vectorise before walking the pool
+	if (!AnyZero(Life, count) && (!BoundsWidth || !AnyOutside(X, min_x, span_x, count)) && (!BoundsHeight || !AnyOutside(Y, min_y, span_y, count)))
+		return;
+
+	//remove dead particles, last live particle takes the slot
+	for (uint16_t i = 0; i < count; )
+	{
+		if (Life[i] && (!BoundsWidth || (uint16_t)(X[i] - min_x) < span_x) && (!BoundsHeight || (uint16_t)(Y[i] - min_y) < span_y))
+		{
+			i++;
+			continue;
+		}
+
+		count--;
+		X[i] = X[count];
+		Y[i] = Y[count];
+		VelocityX[i] = VelocityX[count];
+		VelocityY[i] = VelocityY[count];
+		Life[i] = Life[count];
+	}
+
+	Count = count;
+}
+
+void MAXParticles_Base::draw(MAXBitmap& frame, uint8_t blend)
+{
+	uint16_t width = frame.getWidth();
+	uint16_t height = frame.getHeight();
+
+	for (uint16_t i = 0; i < Count; i++)
+	{
+		//negative positions wrap to large unsigned values, one compare per axis clips both sides
+		uint16_t x = X[i] >> MAXPARTICLE_SHIFT;
+		uint16_t y = Y[i] >> MAXPARTICLE_SHIFT;
+		if (x >= width || y >= height)
+			continue;
+
+		uint8_t* data = frame.getRow(y) + (x >> 3);
+		uint8_t bit = 0x80 >> (x & 0x07);
+
+		if (blend == BlendOr)
+			*data |= bit;
+		else
+			MAXBlendByte(data, bit, bit, blend);
+	}
+}
@@ -0,0 +1,107 @@
+// MAXgfx_Particles.h
+
+#ifndef _MAX72XX_GFX_PARTICLES_h
+#define _MAX72XX_GFX_PARTICLES_h
+
+#include "MAXgfx.h"
+
+//particle positions and velocities are fixed point, 1/16 pixel
+#define MAXPARTICLE_SHIFT 4
+#define MAXPARTICLE_ONE (1 << MAXPARTICLE_SHIFT)
+
+//life of a particle that only dies by leaving the bounds
+#define MAXPARTICLE_FOREVER 0xFF
+
+//update loops run over whole blocks of this many particles (power of 2), storage is rounded up to match
+#ifndef MAXPARTICLE_BLOCK
+	#define MAXPARTICLE_BLOCK 8
+#endif
+
+/** Single pixel particles (sparks, rain, snow) drawn as a display layer.
+ *  State is kept as one array per field rather than one object per particle (9 bytes a particle), live particles
+ *  packed at the front, so update() is a few straight loops over plain arrays the compiler can vectorise on host.
+ *  Dead particles are replaced by the last live one, emitting reuses the slot after it: no allocation, no search.
+ *  draw() sets one bit per particle straight in the framebuffer. */
+class MAXParticles_Base : public MAXDrawable
+{
+
+protected:
+
+	//storage owned by derived class (rounded up to whole blocks), fixed point position and velocity,
+	//steps to live (MAXPARTICLE_FOREVER = no limit)
+	int16_t* X;
+	int16_t* Y;
+	int16_t* VelocityX;
+	int16_t* VelocityY;
+	uint8_t* Life;
+	uint16_t Capacity;
+	uint16_t Count = 0;
+
+	//added to every velocity each step (fixed point)
+	int16_t GravityX = 0;
+	int16_t GravityY = 0;
+
+	//particles leaving the area (in pixels, from BoundsX, BoundsY) die, 0 = no bounds
+	int16_t BoundsX = 0;
+	int16_t BoundsY = 0;
+	int16_t BoundsWidth = 0;
+	int16_t BoundsHeight = 0;
+
+	//xorshift state for emitBurst
+	uint16_t Random = 0xACE1;
+
+	uint32_t Rejected = 0;
+
+	MAXParticles_Base(int16_t* x, int16_t* y, int16_t* velocity_x, int16_t* velocity_y, uint8_t* life, uint16_t capacity);
+
+	uint16_t nextRandom();
+
+public:
+
+	//add a particle at pixel x, y with velocity in 1/16 pixel per step, returns false if the pool is full
+	bool emit(int x, int y, int16_t velocity_x, int16_t velocity_y, uint8_t life = MAXPARTICLE_FOREVER);
+
+	//count particles from pixel x, y with velocity base +- spread in each axis (1/16 pixel per step), life +- life_spread.
+	//returns number emitted
+	uint16_t emitBurst(int x, int y, uint16_t count, int16_t velocity_x, int16_t velocity_y, uint8_t spread_x, uint8_t spread_y, uint8_t life, uint8_t life_spread = 0);
+
+	//advance every particle one step
+	void update();
+
+	void clear() { Count = 0; }
+
+	//settings
+	void setGravity(int16_t gravity_x, int16_t gravity_y) { GravityX = gravity_x; GravityY = gravity_y; }
+	//area particles live in, a negative origin leaves room to spawn above or left of the display (rain, snow)
+	void setBounds(int16_t width, int16_t height, int16_t x = 0, int16_t y = 0) { BoundsWidth = width; BoundsHeight = height; BoundsX = x; BoundsY = y; }
+	void setSeed(uint16_t seed) { Random = seed ? seed : 0xACE1; }
+
+	//pool state
+	uint16_t getCount() { return Count; }
+	uint16_t getCapacity() { return Capacity; }
+	uint32_t getRejected() { return Rejected; }
+
+	void draw(MAXBitmap& frame, uint8_t blend);
+};
+
+/** Particle layer with a pool of CAPACITY particles */
+template <uint16_t CAPACITY>
+class MAXParticles : public MAXParticles_Base
+{
+
+protected:
+
+	static const uint16_t STORAGE = (CAPACITY + MAXPARTICLE_BLOCK - 1) & ~(MAXPARTICLE_BLOCK - 1);
+
+	int16_t XData[STORAGE];
+	int16_t YData[STORAGE];
+	int16_t VelocityXData[STORAGE];
+	int16_t VelocityYData[STORAGE];
+	uint8_t LifeData[STORAGE];
+
+public:
+
+	MAXParticles() : MAXParticles_Base(XData, YData, VelocityXData, VelocityYData, LifeData, CAPACITY) {}
+};
+
+#endif
@@ -0,0 +1,121 @@
+//
+//
+//
+
+#include "MAXgfx_Profile.h"
+
+#include <string.h>
+
+#if !defined(ARDUINO)
+	#include <chrono>
+#endif
+
+namespace
+{
+	const char* const StageNames[ProfileStageCount] = { "update", "composite", "render", "blit", "refresh", "bus" };
+}
+
+namespace MAXProfile
+{
+
+#if MAXGFX_PROFILE
+	MAXProfileStats Current;
+#endif
+
+	void snapshot(MAXProfileStats& stats)
+	{
+#if MAXGFX_PROFILE
+	#if defined(ARDUINO)
+		noInterrupts();
+		stats = Current;
+		interrupts();
+	#else
+		stats = Current;
+	#endif
+#else
+		memset(&stats, 0, sizeof(stats));
+#endif
+	}
+
+	void reset()
+	{
+#if MAXGFX_PROFILE
+	#if defined(ARDUINO)
+		noInterrupts();
+		memset(&Current, 0, sizeof(Current));
+		interrupts();
+	#else
+		memset(&Current, 0, sizeof(Current));
+	#endif
+#endif
+	}
+
+	void addTime(uint8_t stage, uint32_t ticks)
+	{
+#if MAXGFX_PROFILE
+		MAXProfileTimer& timer = Current.Stages[stage];
+		timer.Count++;
+		timer.TotalTicks += ticks;
+		if (ticks > timer.MaxTicks)
+			timer.MaxTicks = ticks;
+#else
+		(void)stage;
+		(void)ticks;
+#endif
+	}
+
+	const char* getStageName(uint8_t stage)
+	{
+		return stage < ProfileStageCount ? StageNames[stage] : "";
+	}
+
+#if defined(ARDUINO)
+
+	void print(Print& out, const MAXProfileStats& stats)
+	{
+		//stage count total max, in ticks
+		for (uint8_t i = 0; i < ProfileStageCount; i++)
+		{
+			out.print(getStageName(i));
+			out.print(" ");
+			out.print((unsigned long)stats.Stages[i].Count);
+			out.print(" ");
+			out.print((unsigned long)stats.Stages[i].TotalTicks);
+			out.print(" ");
+			out.println((unsigned long)stats.Stages[i].MaxTicks);
+		}
+
+		out.print("frames "); out.println((unsigned long)stats.Frames);
+		out.print("renders "); out.println((unsigned long)stats.Renders);
+		out.print("blits "); out.println((unsigned long)stats.Blits);
+		out.print("rows sent "); out.println((unsigned long)stats.RowsSent);
+		out.print("rows skipped "); out.println((unsigned long)stats.RowsSkipped);
+		out.print("bus bytes "); out.println((unsigned long)stats.BusBytes);
+		out.print("sprites skipped "); out.println((unsigned long)stats.SpritesSkipped);
+	}
+
+#else
+
+	void print(FILE* file, const MAXProfileStats& stats)
+	{
+		fprintf(file, "%-10s %10s %12s %10s %10s\n", "stage", "count", "total", "max", "mean");
+		for (uint8_t i = 0; i < ProfileStageCount; i++)
+		{
+			const MAXProfileTimer& timer = stats.Stages[i];
+			fprintf(file, "%-10s %10u %12u %10u %10.1f\n", getStageName(i), (unsigned)timer.Count, (unsigned)timer.TotalTicks, (unsigned)timer.MaxTicks,
+				timer.Count ? (double)timer.TotalTicks / timer.Count : 0.0);
+		}
+
+		fprintf(file, "frames %u, renders %u, blits %u, rows sent %u, rows skipped %u, bus bytes %u, sprites skipped %u\n",
+			(unsigned)stats.Frames, (unsigned)stats.Renders, (unsigned)stats.Blits, (unsigned)stats.RowsSent, (unsigned)stats.RowsSkipped, (unsigned)stats.BusBytes, (unsigned)stats.SpritesSkipped);
+	}
+
+	uint32_t getHostClock()
+	{
+		//nanoseconds, wraps every ~4.3s (stage times are differences, so only the wrap within one stage matters)
+		return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+#endif
+
+}
@@ -0,0 +1,104 @@
+// MAXgfx_Profile.h
+
+#ifndef _MAX72XX_GFX_PROFILE_h
+#define _MAX72XX_GFX_PROFILE_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#elif defined(ARDUINO)
+	#include "WProgram.h"
+#else
+	#include <stdint.h>
+	#include <stdio.h>
+#endif
+
+//instrumentation of the library's own stages, define as 1 in the build flags (every translation unit must agree).
+//when 0 the timers and counters compile to nothing and snapshot() reports zeros
+#ifndef MAXGFX_PROFILE
+	#define MAXGFX_PROFILE 0
+#endif
+
+//time source of the stage timers in ticks: micros() on Arduino, nanoseconds on host.
+//define as a cycle counter (e.g. DWT->CYCCNT on Cortex-M) to time in cycles
+#ifndef MAXGFX_PROFILE_CLOCK
+	#if defined(ARDUINO)
+		#define MAXGFX_PROFILE_CLOCK() ((uint32_t)micros())
+	#else
+		#define MAXGFX_PROFILE_CLOCK() MAXProfile::getHostClock()
+	#endif
+#endif
+
+/** Timed stages. Times are inclusive: Render and Blit run inside Composite, Bus inside Refresh */
+enum enumProfileStage : uint8_t {
+	ProfileUpdate,		//scheduler update step (callback and animations)
+	ProfileComposite,	//layers into the framebuffer
+	ProfileRender,		//sprite display cache rebuild
+	ProfileBlit,		//sprite blitted into the framebuffer (chains)
+	ProfileRefresh,		//dirty row diff and output
+	ProfileBus,			//LOAD cycles on the driver
+	ProfileStageCount
+};
+
+struct MAXProfileTimer
+{
+	uint32_t Count;
+	uint32_t TotalTicks;
+	uint32_t MaxTicks;
+};
+
+struct MAXProfileStats
+{
+	MAXProfileTimer Stages[ProfileStageCount];
+
+	uint32_t Frames;			//frames composited
+	uint32_t Renders;			//sprite display caches rebuilt
+	uint32_t Blits;				//sprites blitted into the framebuffer
+	uint32_t RowsSent;			//digit rows written (one LOAD cycle each)
+	uint32_t RowsSkipped;		//digit rows unchanged since last sent
+	uint32_t BusBytes;			//bytes shifted out, register writes and no-ops included
+	uint32_t SpritesSkipped;	//sprite layers not composited, hidden or entirely off the display
+};
+
+namespace MAXProfile
+{
+	//running totals (only with MAXGFX_PROFILE)
+	extern MAXProfileStats Current;
+
+	//copy of the totals so far (taken with interrupts off on Arduino, an interrupt driven refresh updates them too)
+	void snapshot(MAXProfileStats& stats);
+	void reset();
+	inline bool isEnabled() { return MAXGFX_PROFILE; }
+
+	void addTime(uint8_t stage, uint32_t ticks);
+	const char* getStageName(uint8_t stage);
+
+	//table of stage timers and counters, for a serial console or host harness
+#if defined(ARDUINO)
+	void print(Print& out, const MAXProfileStats& stats);
+#else
+	void print(FILE* file, const MAXProfileStats& stats);
+	uint32_t getHostClock();
+#endif
+}
+
+/** Times the enclosing block as one run of a stage */
+class MAXProfileScope
+{
+	uint8_t Stage;
+	uint32_t Start;
+
+public:
+
+	MAXProfileScope(uint8_t stage) : Stage(stage), Start(MAXGFX_PROFILE_CLOCK()) {}
+	~MAXProfileScope() { MAXProfile::addTime(Stage, MAXGFX_PROFILE_CLOCK() - Start); }
+};
+
+#if MAXGFX_PROFILE
+	#define MAXGFX_PROFILE_SCOPE(stage) MAXProfileScope profile_scope(stage)
+	#define MAXGFX_PROFILE_COUNT(counter, count) (MAXProfile::Current.counter += (count))
+#else
+	#define MAXGFX_PROFILE_SCOPE(stage)
+	#define MAXGFX_PROFILE_COUNT(counter, count)
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+//
+//
+//
+
+#include "MAXgfx_Scheduler.h"
+#include "MAXgfx_Profile.h"
+
+MAXScheduler_Base::MAXScheduler_Base(MAXgfx_Base& display, MAXAnimation* animations, uint8_t animation_capacity, uint32_t step_us) :
+	Display(display), Animations(animations), AnimationCapacity(animation_capacity)
+{
+	setStep(step_us);
+}
+
+MAXAnimation* MAXScheduler_Base::findAnimation(MAXSprite_Animated& sprite)
+{
+	for (uint8_t i = 0; i < AnimationCount; i++)
+	{
+		if (Animations[i].Sprite == &sprite)
+			return &Animations[i];
+	}
+
+	return NULL;
+}
+
+bool MAXScheduler_Base::addAnimation(MAXSprite_Animated& sprite, uint32_t interval_us)
+{
+	if (findAnimation(sprite))
+		return setAnimationInterval(sprite, interval_us);
+
+	if (AnimationCount >= AnimationCapacity)
+		return false;
+
+	MAXAnimation& animation = Animations[AnimationCount++];
+	animation.Sprite = &sprite;
+	animation.IntervalUs = interval_us;
+	animation.ElapsedUs = 0;
+
+	return true;
+}
+
+bool MAXScheduler_Base::setAnimationInterval(MAXSprite_Animated& sprite, uint32_t interval_us)
+{
+	MAXAnimation* animation = findAnimation(sprite);
+	if (!animation)
+		return false;
+
+	animation->IntervalUs = interval_us;
+	if (animation->ElapsedUs >= interval_us)
+		animation->ElapsedUs = 0;
+
+	return true;
+}
+
+bool MAXScheduler_Base::removeAnimation(MAXSprite_Animated& sprite)
+{
+	MAXAnimation* animation = findAnimation(sprite);
+	if (!animation)
+		return false;
+
+	//order doesn't matter, move last one into the gap
+	*animation = Animations[--AnimationCount];
+
+	return true;
+}
+
+void MAXScheduler_Base::step()
+{
+	MAXGFX_PROFILE_SCOPE(ProfileUpdate);
+	Steps++;
+
+	if (Update)
+		Update(UpdateContext);
+
+	for (uint8_t i = 0; i < AnimationCount; i++)
+	{
+		MAXAnimation& animation = Animations[i];
+		if (!animation.IntervalUs)
+			continue;
+
+		//more than one frame per step if the interval is shorter than the step
+		animation.ElapsedUs += StepUs;
+		while (animation.ElapsedUs >= animation.IntervalUs)
+		{
+			animation.ElapsedUs -= animation.IntervalUs;
+			animation.Sprite->nextFrame();
+		}
+	}
+}
+
+uint8_t MAXScheduler_Base::tick(uint32_t now_us)
+{
+	//first tick composites straight away
+	if (!Started)
+	{
+		Started = true;
+		LastTickUs = now_us;
+		AccumulatorUs = StepUs;
+	}
+
+	//unsigned difference handles micros() wrap around
+	AccumulatorUs += now_us - LastTickUs;
+	LastTickUs = now_us;
+
+	uint8_t steps = 0;
+	while (AccumulatorUs >= StepUs)
+	{
+		//too far behind, drop the backlog instead of running steps back to back
+		if (steps == MaxCatchUp)
+		{
+			DroppedFrames += AccumulatorUs / StepUs;
+			AccumulatorUs %= StepUs;
+			break;
+		}
+
+		AccumulatorUs -= StepUs;
+		step();
+		steps++;
+	}
+
+	if (steps)
+	{
+		//only the last step's state is shown
+		DroppedFrames += steps - 1;
+
+		//previous frame still going out (or not yet taken by a double buffered sender), compositing now would tear it
+		if (Display.isFramePending())
+			DroppedFrames++;
+		else
+		{
+			Display.composite();
+			Display.present();
+			Frames++;
+
+			//time since the slot of the step just run
+			JitterSumUs += AccumulatorUs;
+			if (AccumulatorUs > MaxJitterUs)
+				MaxJitterUs = AccumulatorUs;
+		}
+	}
+
+	//refresh stage, unless an interrupt or DMA sender does it
+	if (RefreshInTick)
+		Display.refreshRows(RowsPerTick ? RowsPerTick : MATRIX_DIM);
+
+	return steps;
+}
@@ -0,0 +1,119 @@
+// MAXgfx_Scheduler.h
+
+#ifndef _MAX72XX_GFX_SCHEDULER_h
+#define _MAX72XX_GFX_SCHEDULER_h
+
+#include "MAXgfx.h"
+
+/** Animated sprite (multi-frame, delta...) advanced by a MAXScheduler every IntervalUs */
+struct MAXAnimation
+{
+	MAXSprite_Animated* Sprite;
+	uint32_t IntervalUs;
+	uint32_t ElapsedUs;
+};
+
+//game logic run once per fixed step
+typedef void (*MAXUpdateCallback)(void* context);
+
+/** Fixed timestep frame scheduler for a display.
+ *  tick() is called as often as the loop allows. Every StepUs of elapsed time it runs one update step (callback and
+ *  sprite animations), then composites one frame for all steps due. Rows of that frame are sent either all at once or
+ *  RowsPerTick at a time over the following ticks, so a single tick never blocks for a whole frame's bus time. */
+class MAXScheduler_Base
+{
+
+protected:
+
+	MAXgfx_Base& Display;
+
+	//animation pool (storage owned by derived class)
+	MAXAnimation* Animations;
+	uint8_t AnimationCapacity;
+	uint8_t AnimationCount = 0;
+
+	//timing
+	uint32_t StepUs;
+	uint32_t LastTickUs = 0;
+	uint32_t AccumulatorUs = 0;
+	bool Started = false;
+
+	//steps run in one tick before the backlog is dropped
+	uint8_t MaxCatchUp = 4;
+
+	//rows sent per tick (0 = whole frame in the tick it was composited)
+	uint8_t RowsPerTick = 0;
+	bool RefreshInTick = true;
+
+	MAXUpdateCallback Update = NULL;
+	void* UpdateContext = NULL;
+
+	//statistics
+	uint32_t Frames = 0;
+	uint32_t Steps = 0;
+	uint32_t DroppedFrames = 0;
+	uint32_t MaxJitterUs = 0;
+	uint32_t JitterSumUs = 0;
+
+	MAXScheduler_Base(MAXgfx_Base& display, MAXAnimation* animations, uint8_t animation_capacity, uint32_t step_us);
+
+	//one fixed update step
+	void step();
+
+	MAXAnimation* findAnimation(MAXSprite_Animated& sprite);
+
+public:
+
+	//timestep
+	void setStep(uint32_t step_us) { StepUs = step_us ? step_us : 1; }
+	void setFrameRate(uint16_t frames_per_second) { setStep(1000000UL / (frames_per_second ? frames_per_second : 1)); }
+	uint32_t getStep() { return StepUs; }
+	void setMaxCatchUp(uint8_t steps) { MaxCatchUp = steps ? steps : 1; }
+
+	//refresh stage, rows_per_tick = 0 sends each frame at once
+	void setRowsPerTick(uint8_t rows_per_tick) { RowsPerTick = rows_per_tick; }
+	//false when frames are sent by an interrupt or DMA sender calling refreshRows (double buffered display)
+	void setRefreshInTick(bool refresh_in_tick) { RefreshInTick = refresh_in_tick; }
+
+	void setUpdateCallback(MAXUpdateCallback update, void* context = NULL) { Update = update; UpdateContext = context; }
+
+	//animations, interval of 0 pauses the animation
+	bool addAnimation(MAXSprite_Animated& sprite, uint32_t interval_us);
+	bool setAnimationInterval(MAXSprite_Animated& sprite, uint32_t interval_us);
+	bool removeAnimation(MAXSprite_Animated& sprite);
+	uint8_t getAnimationCount() { return AnimationCount; }
+
+	//advance to now_us (wraps like micros()), returns number of update steps run
+	uint8_t tick(uint32_t now_us);
+#if defined(ARDUINO)
+	uint8_t tick() { return tick(micros()); }
+#endif
+
+	//restart timing (e.g. after the loop has been paused), next tick composites a frame
+	void restart() { Started = false; }
+
+	//statistics: frames composited, update steps, frames never shown (catch-up, backlog dropped or previous frame still
+	//being sent) and jitter = how late a frame was composited relative to its step's slot on the fixed timeline
+	uint32_t getFrames() { return Frames; }
+	uint32_t getSteps() { return Steps; }
+	uint32_t getDroppedFrames() { return DroppedFrames; }
+	uint32_t getMaxJitterUs() { return MaxJitterUs; }
+	uint32_t getAverageJitterUs() { return Frames ? JitterSumUs / Frames : 0; }
+	void resetStats() { Frames = 0; Steps = 0; DroppedFrames = 0; MaxJitterUs = 0; JitterSumUs = 0; }
+};
+
+/** Scheduler with room for ANIMATION_CNT animated sprites */
+template <uint8_t ANIMATION_CNT = SPRITE_LOCATION_CNT>
+class MAXScheduler : public MAXScheduler_Base
+{
+
+protected:
+
+	MAXAnimation AnimationData[ANIMATION_CNT];
+
+public:
+
+	MAXScheduler(MAXgfx_Base& display, uint32_t step_us = 20000) : MAXScheduler_Base(display, AnimationData, ANIMATION_CNT, step_us) {}
+};
+
+#endif
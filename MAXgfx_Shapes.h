@@ -0,0 +1,150 @@
+// MAXgfx_Shapes.h
+
+#ifndef _MAX72XX_GFX_SHAPES_h
+#define _MAX72XX_GFX_SHAPES_h
+
+#include "MAXgfx.h"
+
+/** Rows of primitive shapes as constexpr functions (MSB = leftmost pixel), shared by the runtime sprites
+ *  (MAXSprite_Rectangle, MAXSprite_StraightLine) and the compile time shape tables below */
+namespace MAXShape
+{
+	//leftmost width pixels of a row
+	constexpr uint8_t rowMask(uint8_t width) { return width >= MATRIX_DIM ? 0xFF : (uint8_t)~(0xFF >> width); }
+
+	//thickest border of a rectangle (half the smaller side, 1 for shapes only 1 pixel high or wide)
+	constexpr uint8_t maxBorder(uint8_t smallest_dim) { return smallest_dim > 1 ? smallest_dim / 2 : 1; }
+	constexpr uint8_t rectangleBorder(uint8_t width, uint8_t height, uint8_t border_thickness)
+	{
+		return border_thickness > maxBorder(width < height ? width : height) ? maxBorder(width < height ? width : height) : border_thickness;
+	}
+
+	//row of a rectangle outline (or filled rectangle), border already limited by rectangleBorder
+	constexpr uint8_t rectangleRow(uint8_t width, uint8_t height, uint8_t border, bool filled, uint8_t row)
+	{
+		return row >= height ? 0x00 :
+			(filled || row < border || row + border >= height) ? rowMask(width) :
+			(uint8_t)(rowMask(border) | (rowMask(width) & ~rowMask(width - border)));
+	}
+
+	//row of a straight line, horizontal lines are thickness rows high, vertical ones thickness columns wide
+	constexpr uint8_t lineRow(uint8_t length, uint8_t thickness, bool vertical, uint8_t row)
+	{
+		return vertical ? (row < length ? rowMask(thickness) : 0x00) : (row < thickness ? rowMask(length) : 0x00);
+	}
+
+	//row of a 45 degree line across a size x size square, top left to bottom right (or bottom left to top right if rising)
+	constexpr uint8_t diagonalRow(uint8_t size, bool rising, uint8_t row)
+	{
+		return row >= size ? 0x00 : (uint8_t)(0x80 >> (rising ? size - 1 - row : row));
+	}
+
+	//one row of alternating cell_size pixel wide runs, first run set
+	constexpr uint8_t checkerPattern(uint8_t cell_size, uint8_t column = 0)
+	{
+		return column >= MATRIX_DIM ? 0x00 :
+			(uint8_t)((((column / cell_size) & 1) ? 0x00 : (0x80 >> column)) | checkerPattern(cell_size, column + 1));
+	}
+
+	//row of a checkerboard with square cells of cell_size pixels, top left cell set
+	constexpr uint8_t checkerRow(uint8_t width, uint8_t height, uint8_t cell_size, uint8_t row)
+	{
+		return row >= height ? 0x00 :
+			(uint8_t)(rowMask(width) & (((row / cell_size) & 1) ? (uint8_t)~checkerPattern(cell_size) : checkerPattern(cell_size)));
+	}
+}
+
+/** Compile time shapes: 8 row bitmaps generated by the compiler and stored in flash, with Width and Height.
+ *  Use them through MAXSprite_Static (or MAXSprite::initSprite_P), nothing is computed or copied at runtime */
+template <uint8_t WIDTH, uint8_t HEIGHT, uint8_t BORDER = 1, bool FILLED = false>
+struct MAXShape_Rectangle
+{
+	static_assert(WIDTH <= MATRIX_DIM && HEIGHT <= MATRIX_DIM, "rectangle larger than a matrix");
+
+	static const uint8_t Width = WIDTH;
+	static const uint8_t Height = HEIGHT;
+	static const uint8_t Border = MAXShape::rectangleBorder(WIDTH, HEIGHT, BORDER);
+	static const uint8_t Data[MATRIX_DIM];
+};
+
+template <uint8_t WIDTH, uint8_t HEIGHT, uint8_t BORDER, bool FILLED>
+const uint8_t MAXShape_Rectangle<WIDTH, HEIGHT, BORDER, FILLED>::Data[MATRIX_DIM] PROGMEM =
+{
+	MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 0), MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 1),
+	MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 2), MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 3),
+	MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 4), MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 5),
+	MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 6), MAXShape::rectangleRow(WIDTH, HEIGHT, Border, FILLED, 7)
+};
+
+template <uint8_t LENGTH, uint8_t THICKNESS = 1, bool VERTICAL = false>
+struct MAXShape_Line
+{
+	static_assert(LENGTH <= MATRIX_DIM && THICKNESS <= MATRIX_DIM, "line longer or thicker than a matrix");
+
+	static const uint8_t Width = VERTICAL ? THICKNESS : LENGTH;
+	static const uint8_t Height = VERTICAL ? LENGTH : THICKNESS;
+	static const uint8_t Data[MATRIX_DIM];
+};
+
+template <uint8_t LENGTH, uint8_t THICKNESS, bool VERTICAL>
+const uint8_t MAXShape_Line<LENGTH, THICKNESS, VERTICAL>::Data[MATRIX_DIM] PROGMEM =
+{
+	MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 0), MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 1),
+	MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 2), MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 3),
+	MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 4), MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 5),
+	MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 6), MAXShape::lineRow(LENGTH, THICKNESS, VERTICAL, 7)
+};
+
+template <uint8_t SIZE, bool RISING = false>
+struct MAXShape_Diagonal
+{
+	static_assert(SIZE <= MATRIX_DIM, "diagonal larger than a matrix");
+
+	static const uint8_t Width = SIZE;
+	static const uint8_t Height = SIZE;
+	static const uint8_t Data[MATRIX_DIM];
+};
+
+template <uint8_t SIZE, bool RISING>
+const uint8_t MAXShape_Diagonal<SIZE, RISING>::Data[MATRIX_DIM] PROGMEM =
+{
+	MAXShape::diagonalRow(SIZE, RISING, 0), MAXShape::diagonalRow(SIZE, RISING, 1),
+	MAXShape::diagonalRow(SIZE, RISING, 2), MAXShape::diagonalRow(SIZE, RISING, 3),
+	MAXShape::diagonalRow(SIZE, RISING, 4), MAXShape::diagonalRow(SIZE, RISING, 5),
+	MAXShape::diagonalRow(SIZE, RISING, 6), MAXShape::diagonalRow(SIZE, RISING, 7)
+};
+
+template <uint8_t WIDTH, uint8_t HEIGHT, uint8_t CELL_SIZE = 1>
+struct MAXShape_Checker
+{
+	static_assert(WIDTH <= MATRIX_DIM && HEIGHT <= MATRIX_DIM && CELL_SIZE > 0, "invalid checkerboard size");
+
+	static const uint8_t Width = WIDTH;
+	static const uint8_t Height = HEIGHT;
+	static const uint8_t Data[MATRIX_DIM];
+};
+
+template <uint8_t WIDTH, uint8_t HEIGHT, uint8_t CELL_SIZE>
+const uint8_t MAXShape_Checker<WIDTH, HEIGHT, CELL_SIZE>::Data[MATRIX_DIM] PROGMEM =
+{
+	MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 0), MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 1),
+	MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 2), MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 3),
+	MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 4), MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 5),
+	MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 6), MAXShape::checkerRow(WIDTH, HEIGHT, CELL_SIZE, 7)
+};
+
+/** Sprite showing a compile time shape (MAXShape_Rectangle, MAXShape_Line, ...), read in place from flash.
+ *  e.g. MAXSprite_Static<MAXShape_Rectangle<8, 8> > border(0, 0); */
+template <class SHAPE>
+class MAXSprite_Static : public MAXSprite
+{
+
+public:
+
+	MAXSprite_Static(int position_x = 0, int position_y = 0, uint8_t position_constraints = NoEdges, bool show = true)
+	{
+		initSprite_P(SHAPE::Data, SHAPE::Width, SHAPE::Height, position_x, position_y, position_constraints, show);
+	}
+};
+
+#endif
@@ -0,0 +1,255 @@
+//
+//
+//
+
+#include "MAXgfx_SpatialIndex.h"
+
+MAXSpatialIndex_Base::MAXSpatialIndex_Base(uint8_t cols, uint8_t rows, Entry* entries, uint16_t* next, uint16_t* prev, uint16_t* heads, uint16_t capacity) :
+	Cols(cols), Rows(rows), Entries(entries), Next(next), Prev(prev), Heads(heads), Capacity(capacity)
+{
+	//all cells empty
+	for (uint16_t i = 0; i < Cols * Rows; i++)
+		Heads[i] = INDEX_NONE;
+
+	//all entries start on the free list
+	for (uint16_t i = 0; i < Capacity; i++)
+	{
+		Entries[i].Sprite = NULL;
+		Next[i * 4] = (i + 1 < Capacity) ? i + 1 : INDEX_NONE;
+	}
+	FreeEntry = Capacity ? 0 : INDEX_NONE;
+}
+
+uint16_t MAXSpatialIndex_Base::getNodeCell(uint16_t node)
+{
+	Entry& entry = Entries[node >> 2];
+	uint8_t corner = node & 0x03;
+
+	int16_t x = entry.CellX0 + (corner & 0x01);
+	int16_t y = entry.CellY0 + (corner >> 1);
+	if (x > entry.CellX1 || y > entry.CellY1)
+		return INDEX_NONE;
+
+	return y * Cols + x;
+}
+
+void MAXSpatialIndex_Base::linkNode(uint16_t node, uint16_t cell)
+{
+	Prev[node] = INDEX_NONE;
+	Next[node] = Heads[cell];
+	if (Heads[cell] != INDEX_NONE)
+		Prev[Heads[cell]] = node;
+	Heads[cell] = node;
+}
+
+void MAXSpatialIndex_Base::unlinkNode(uint16_t node, uint16_t cell)
+{
+	if (Prev[node] != INDEX_NONE)
+		Next[Prev[node]] = Next[node];
+	else
+		Heads[cell] = Next[node];
+
+	if (Next[node] != INDEX_NONE)
+		Prev[Next[node]] = Prev[node];
+}
+
+void MAXSpatialIndex_Base::linkEntry(uint16_t entry)
+{
+	for (uint16_t node = entry * 4; node < entry * 4 + 4; node++)
+	{
+		uint16_t cell = getNodeCell(node);
+		if (cell != INDEX_NONE)
+			linkNode(node, cell);
+	}
+}
+
+void MAXSpatialIndex_Base::unlinkEntry(uint16_t entry)
+{
+	for (uint16_t node = entry * 4; node < entry * 4 + 4; node++)
+	{
+		uint16_t cell = getNodeCell(node);
+		if (cell != INDEX_NONE)
+			unlinkNode(node, cell);
+	}
+}
+
+void MAXSpatialIndex_Base::getCells(int x, int y, int width, int height, int16_t& x0, int16_t& y0, int16_t& x1, int16_t& y1)
+{
+	x0 = getCell(x, Cols);
+	y0 = getCell(y, Rows);
+	x1 = getCell(x + (width > 0 ? width : 1) - 1, Cols);
+	y1 = getCell(y + (height > 0 ? height : 1) - 1, Rows);
+}
+
+bool MAXSpatialIndex_Base::addSprite(MAXSprite& sprite)
+{
+	if (sprite.Index || FreeEntry == INDEX_NONE)
+		return false;
+
+	//take first free entry
+	uint16_t entry = FreeEntry;
+	FreeEntry = Next[entry * 4];
+
+	Entry& new_entry = Entries[entry];
+	new_entry.Sprite = &sprite;
+	getCells(sprite.getPositionX(), sprite.getPositionY(), sprite.getWidth(), sprite.getHeight(), new_entry.CellX0, new_entry.CellY0, new_entry.CellX1, new_entry.CellY1);
+	linkEntry(entry);
+
+	sprite.Index = this;
+	sprite.IndexEntry = entry;
+	Count++;
+
+	return true;
+}
+
+bool MAXSpatialIndex_Base::removeSprite(MAXSprite& sprite)
+{
+	uint16_t entry = getEntry(sprite);
+	if (entry == INDEX_NONE)
+		return false;
+
+	unlinkEntry(entry);
+
+	//return entry to free list
+	Entries[entry].Sprite = NULL;
+	Next[entry * 4] = FreeEntry;
+	FreeEntry = entry;
+
+	sprite.Index = NULL;
+	Count--;
+
+	return true;
+}
+
+void MAXSpatialIndex_Base::updateSprite(MAXSprite& sprite)
+{
+	uint16_t entry = getEntry(sprite);
+	if (entry == INDEX_NONE)
+		return;
+
+	Entry& current = Entries[entry];
+
+	int16_t x0, y0, x1, y1;
+	getCells(current.Sprite->getPositionX(), current.Sprite->getPositionY(), current.Sprite->getWidth(), current.Sprite->getHeight(), x0, y0, x1, y1);
+
+	//still in the same cells
+	if (x0 == current.CellX0 && y0 == current.CellY0 && x1 == current.CellX1 && y1 == current.CellY1)
+		return;
+
+	unlinkEntry(entry);
+	current.CellX0 = x0;
+	current.CellY0 = y0;
+	current.CellX1 = x1;
+	current.CellY1 = y1;
+	linkEntry(entry);
+}
+
+bool MAXSpatialIndex_Base::passesTest(MAXSprite& other, int x, int y, int width, int height, MAXSprite* sprite, uint8_t test)
+{
+	if (&other == sprite || other.isHidden())
+		return false;
+
+	//bounding box against region
+	if (other.getPositionX() + other.getWidth() <= x || other.getPositionX() >= x + width ||
+		other.getPositionY() + other.getHeight() <= y || other.getPositionY() >= y + height)
+		return false;
+
+	switch (test)
+	{
+	case TestOverlap: return MAXgfx_Base::isOverlapping(*sprite, other);
+	case TestTouch: return sprite->isTouchingSprite(other);
+	default: return true;
+	}
+}
+
+uint16_t MAXSpatialIndex_Base::collect(int x, int y, int width, int height, MAXSprite* sprite, uint8_t test, MAXSprite** results, uint16_t max_results)
+{
+	uint16_t found = 0;
+
+	if (width <= 0 || height <= 0)
+		return 0;
+
+	//cells covered by the region
+	int16_t x0, y0, x1, y1;
+	getCells(x, y, width, height, x0, y0, x1, y1);
+
+	for (int16_t cell_y = y0; cell_y <= y1; cell_y++)
+	{
+		for (int16_t cell_x = x0; cell_x <= x1; cell_x++)
+		{
+			for (uint16_t node = Heads[cell_y * Cols + cell_x]; node != INDEX_NONE; node = Next[node])
+			{
+				Entry& entry = Entries[node >> 2];
+
+				//sprites in several cells are reported from the first cell both cover
+				if ((entry.CellX0 > x0 ? entry.CellX0 : x0) != cell_x || (entry.CellY0 > y0 ? entry.CellY0 : y0) != cell_y)
+					continue;
+
+				if (!passesTest(*entry.Sprite, x, y, width, height, sprite, test))
+					continue;
+
+				if (found == max_results)
+					return found;
+				results[found++] = entry.Sprite;
+			}
+		}
+	}
+
+	return found;
+}
+
+uint16_t MAXSpatialIndex_Base::query(int x, int y, int width, int height, MAXSprite** results, uint16_t max_results)
+{
+	return collect(x, y, width, height, NULL, TestBounds, results, max_results);
+}
+
+uint16_t MAXSpatialIndex_Base::queryOverlapping(MAXSprite& sprite, MAXSprite** results, uint16_t max_results)
+{
+	return collect(sprite.getPositionX(), sprite.getPositionY(), sprite.getWidth(), sprite.getHeight(), &sprite, TestOverlap, results, max_results);
+}
+
+uint16_t MAXSpatialIndex_Base::queryTouching(MAXSprite& sprite, MAXSprite** results, uint16_t max_results)
+{
+	//neighbours are up to one pixel outside the sprite
+	return collect(sprite.getPositionX() - 1, sprite.getPositionY() - 1, sprite.getWidth() + 2, sprite.getHeight() + 2, &sprite, TestTouch, results, max_results);
+}
+
+uint16_t MAXSpatialIndex_Base::findOverlaps(MAXSpritePair* pairs, uint16_t max_pairs)
+{
+	uint16_t found = 0;
+
+	//pairs within each cell
+	for (uint16_t cell = 0; cell < Cols * Rows; cell++)
+	{
+		for (uint16_t node1 = Heads[cell]; node1 != INDEX_NONE; node1 = Next[node1])
+		{
+			Entry& entry1 = Entries[node1 >> 2];
+			if (entry1.Sprite->isHidden())
+				continue;
+
+			for (uint16_t node2 = Next[node1]; node2 != INDEX_NONE; node2 = Next[node2])
+			{
+				Entry& entry2 = Entries[node2 >> 2];
+				if (entry2.Sprite->isHidden())
+					continue;
+
+				//pairs sharing several cells are tested in the first one only
+				int16_t first_x = entry1.CellX0 > entry2.CellX0 ? entry1.CellX0 : entry2.CellX0;
+				int16_t first_y = entry1.CellY0 > entry2.CellY0 ? entry1.CellY0 : entry2.CellY0;
+				if (first_y * Cols + first_x != cell)
+					continue;
+
+				if (!MAXgfx_Base::isOverlapping(*entry1.Sprite, *entry2.Sprite))
+					continue;
+
+				if (found == max_pairs)
+					return found;
+				pairs[found].Sprite1 = entry1.Sprite;
+				pairs[found].Sprite2 = entry2.Sprite;
+				found++;
+			}
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,125 @@
+// MAXgfx_SpatialIndex.h
+
+#ifndef _MAX72XX_GFX_SPATIALINDEX_h
+#define _MAX72XX_GFX_SPATIALINDEX_h
+
+#include "MAXgfx.h"
+
+//invalid entry / node, end of a list
+#define INDEX_NONE 0xFFFF
+
+/** Pair of overlapping sprites found by MAXSpatialIndex_Base::findOverlaps */
+struct MAXSpritePair
+{
+	MAXSprite* Sprite1;
+	MAXSprite* Sprite2;
+};
+
+/** Uniform grid of module sized (MATRIX_DIM x MATRIX_DIM) cells, each listing the sprites whose bounding box
+ *  covers it. A sprite (at most MATRIX_DIM square) covers at most 2 x 2 cells, so it has 4 list nodes of its own.
+ *  Sprites update their cells from setPosition (and so move, setTransform, init...), a move within the same cells
+ *  costs nothing. Queries visit only the cells they cover, so cost depends on local density, not sprite count.
+ *  Anything past the edge of the grid is kept in the nearest edge cells, so sprites off the display are still found.
+ *  Hidden sprites stay indexed but aren't returned. Remove sprites before they are destroyed. */
+class MAXSpatialIndex_Base
+{
+
+protected:
+
+	struct Entry
+	{
+		MAXSprite* Sprite;
+
+		//cells covered
+		int16_t CellX0;
+		int16_t CellY0;
+		int16_t CellX1;
+		int16_t CellY1;
+	};
+
+	//grid size in cells
+	uint8_t Cols;
+	uint8_t Rows;
+
+	//storage owned by derived class: entries, 4 nodes per entry (node = entry * 4 + corner), list head per cell.
+	//free entries are linked through the Next of their first node
+	Entry* Entries;
+	uint16_t* Next;
+	uint16_t* Prev;
+	uint16_t* Heads;
+	uint16_t Capacity;
+	uint16_t Count = 0;
+	uint16_t FreeEntry;
+
+	MAXSpatialIndex_Base(uint8_t cols, uint8_t rows, Entry* entries, uint16_t* next, uint16_t* prev, uint16_t* heads, uint16_t capacity);
+
+	//cell of a node, NONE if the entry doesn't cover that corner
+	uint16_t getNodeCell(uint16_t node);
+
+	//list helpers
+	void linkNode(uint16_t node, uint16_t cell);
+	void unlinkNode(uint16_t node, uint16_t cell);
+	void linkEntry(uint16_t entry);
+	void unlinkEntry(uint16_t entry);
+
+	//sprite's entry in this index, INDEX_NONE if it isn't in it
+	uint16_t getEntry(MAXSprite& sprite) { return sprite.Index == this && sprite.IndexEntry < Capacity && Entries[sprite.IndexEntry].Sprite == &sprite ? sprite.IndexEntry : INDEX_NONE; }
+
+	//cell of a coordinate, clamped to the grid
+	static int16_t getCell(int position, uint8_t cells) { return position < 0 ? 0 : (position / MATRIX_DIM >= cells ? cells - 1 : position / MATRIX_DIM); }
+
+	//cell range of a region (at least one pixel)
+	void getCells(int x, int y, int width, int height, int16_t& x0, int16_t& y0, int16_t& x1, int16_t& y1);
+
+	//tests applied to sprites found in a region
+	enum enumTest : uint8_t {
+		TestBounds,		//bounding box intersects region
+		TestOverlap,	//pixels overlap sprite
+		TestTouch		//touches sprite edge to edge
+	};
+
+	//every shown sprite in the region (other than sprite) passing test against sprite, each once
+	uint16_t collect(int x, int y, int width, int height, MAXSprite* sprite, uint8_t test, MAXSprite** results, uint16_t max_results);
+	bool passesTest(MAXSprite& other, int x, int y, int width, int height, MAXSprite* sprite, uint8_t test);
+
+public:
+
+	//add or remove a sprite, add returns false if the index is full or the sprite is already in an index
+	bool addSprite(MAXSprite& sprite);
+	bool removeSprite(MAXSprite& sprite);
+	uint16_t getCount() { return Count; }
+	uint16_t getCapacity() { return Capacity; }
+
+	//called by MAXSprite when its position or size has changed
+	void updateSprite(MAXSprite& sprite);
+
+	//shown sprites whose bounding box intersects the region, returns number stored in results
+	uint16_t query(int x, int y, int width, int height, MAXSprite** results, uint16_t max_results);
+
+	//shown sprites overlapping a sprite (pixel accurate), or touching it edge to edge (MAXSprite::isTouchingSprite)
+	uint16_t queryOverlapping(MAXSprite& sprite, MAXSprite** results, uint16_t max_results);
+	uint16_t queryTouching(MAXSprite& sprite, MAXSprite** results, uint16_t max_results);
+
+	//all pairs of overlapping shown sprites (pixel accurate), each pair once
+	uint16_t findOverlaps(MAXSpritePair* pairs, uint16_t max_pairs);
+};
+
+/** Spatial index over a display of MODULE_COLS x MODULE_ROWS modules, for up to CAPACITY sprites */
+template <uint8_t MODULE_COLS, uint8_t MODULE_ROWS = 1, uint16_t CAPACITY = 64>
+class MAXSpatialIndex : public MAXSpatialIndex_Base
+{
+	static_assert(CAPACITY <= 0x3FFF, "nodes (4 per entry) must fit below INDEX_NONE in 16 bits");
+
+protected:
+
+	Entry EntryData[CAPACITY];
+	uint16_t NextData[CAPACITY * 4];
+	uint16_t PrevData[CAPACITY * 4];
+	uint16_t HeadData[MODULE_COLS * MODULE_ROWS];
+
+public:
+
+	MAXSpatialIndex() : MAXSpatialIndex_Base(MODULE_COLS, MODULE_ROWS, EntryData, NextData, PrevData, HeadData, CAPACITY) {}
+};
+
+#endif
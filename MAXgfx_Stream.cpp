@@ -0,0 +1,346 @@
+//
+//
+//
+
+#include "MAXgfx_Stream.h"
+
+uint16_t MAXStream::encodeFrame(const uint8_t* frame, const uint8_t* previous, uint16_t stride, uint16_t rows, uint8_t sequence, bool keyframe, uint8_t* output, uint16_t max_size)
+{
+	if (!previous)
+		keyframe = true;
+
+	uint32_t size = MAXSTREAM_HEADER_SIZE;
+	if (size + 1 > max_size || rows > MAXSTREAM_MAX_ROWS)
+		return 0;
+
+	//spans of rows to send (every row for a keyframe, changed ones otherwise), at most 255 rows each
+	for (uint16_t row = 0; row < rows; )
+	{
+		if (!keyframe && !memcmp(frame + row * stride, previous + row * stride, stride))
+		{
+			row++;
+			continue;
+		}
+
+		uint16_t first = row;
+		while (row < rows && row - first < 0xFF && (keyframe || memcmp(frame + row * stride, previous + row * stride, stride)))
+			row++;
+
+		uint16_t count = row - first;
+		if (size + 2 + count * stride + 1 > max_size)
+			return 0;
+
+		output[size++] = first;
+		output[size++] = count;
+		memcpy(output + size, frame + first * stride, count * stride);
+		size += count * stride;
+	}
+
+	uint16_t length = size - MAXSTREAM_HEADER_SIZE;
+	output[0] = MAXSTREAM_SYNC;
+	output[1] = keyframe ? MAXSTREAM_KEYFRAME : 0x00;
+	output[2] = sequence;
+	output[3] = length & 0xFF;
+	output[4] = length >> 8;
+
+	//checksum makes the sum of everything after sync zero
+	uint8_t sum = 0;
+	for (uint16_t i = 1; i < size; i++)
+		sum += output[i];
+	output[size++] = -sum;
+
+	return size;
+}
+
+MAXStreamPlayer_Base::MAXStreamPlayer_Base(uint8_t* ring, uint16_t ring_size, uint8_t* picture_data, uint16_t width, uint16_t height) :
+	Ring(ring), RingMask(ring_size - 1), Picture(picture_data, width, height)
+{
+}
+
+void MAXStreamPlayer_Base::copyOut(uint16_t offset, uint8_t* destination, uint16_t count)
+{
+	//at most two pieces, the second from the start of the ring
+	uint16_t start = (Tail + offset) & RingMask;
+	uint16_t first = RingMask + 1 - start;
+	if (first > count)
+		first = count;
+
+	memcpy(destination, Ring + start, first);
+	memcpy(destination + first, Ring, count - first);
+}
+
+bool MAXStreamPlayer_Base::applySpans(uint16_t length, bool check)
+{
+	uint16_t offset = MAXSTREAM_HEADER_SIZE;
+	uint16_t end = offset + length;
+
+	while (offset < end)
+	{
+		if (end - offset < 2)
+			return false;
+
+		uint8_t first = peek(offset);
+		uint8_t count = peek(offset + 1);
+		uint16_t bytes = count * Picture.getStride();
+		offset += 2;
+
+		//rows must be inside the picture and the payload
+		if (first + count > Picture.getHeight() || end - offset < bytes)
+			return false;
+
+		if (!check)
+			copyOut(offset, Picture.getRow(first), bytes);
+		offset += bytes;
+	}
+
+	return true;
+}
+
+bool MAXStreamPlayer_Base::processPacket(bool& applied)
+{
+	applied = false;
+
+	//skip anything before the next sync byte
+	uint16_t used = getUsed();
+	uint16_t skipped = 0;
+	while (skipped < used && peek(skipped) != MAXSTREAM_SYNC)
+		skipped++;
+
+	if (skipped)
+	{
+		discard(skipped);
+		BytesDiscarded += skipped;
+		used -= skipped;
+	}
+
+	if (used < MAXSTREAM_HEADER_SIZE)
+		return false;
+
+	//packet must fit in the ring, or this isn't a real header
+	uint16_t length = peek(3) | (peek(4) << 8);
+	uint32_t total = (uint32_t)MAXSTREAM_HEADER_SIZE + length + 1;
+	bool valid = total <= RingMask;
+
+	if (valid)
+	{
+		if (used < total)
+			return false;
+
+		uint8_t sum = 0;
+		for (uint16_t i = 1; i < total; i++)
+			sum += peek(i);
+		valid = !sum && applySpans(length, true);
+	}
+
+	//false sync or corrupt packet, look for the next sync from the byte after this one
+	if (!valid)
+	{
+		discard(1);
+		BadPackets++;
+		BytesDiscarded++;
+		return true;
+	}
+
+	bool keyframe = peek(1) & MAXSTREAM_KEYFRAME;
+	uint8_t sequence = peek(2);
+
+	//a frame went missing, changes can't be applied until the next keyframe
+	if (!keyframe && (WaitKeyframe || sequence != NextSequence))
+	{
+		WaitKeyframe = true;
+		FramesDropped++;
+		discard(total);
+		return true;
+	}
+
+	//previous frame was never drawn
+	if (FramePending)
+		FramesDropped++;
+
+	applySpans(length, false);
+	discard(total);
+
+	NextSequence = sequence + 1;
+	WaitKeyframe = false;
+	FramePending = true;
+	FramesReceived++;
+	applied = true;
+
+	return true;
+}
+
+uint16_t MAXStreamPlayer_Base::getWriteSpan(uint8_t*& data)
+{
+	//free space up to the end of the ring
+	uint16_t span = RingMask + 1 - Head;
+	if (span > getFree())
+		span = getFree();
+
+	data = Ring + Head;
+	return span;
+}
+
+void MAXStreamPlayer_Base::commitWrite(uint16_t count)
+{
+	Head = (Head + count) & RingMask;
+	BytesReceived += count;
+
+	if (getUsed() > MaxUsed)
+		MaxUsed = getUsed();
+}
+
+uint16_t MAXStreamPlayer_Base::write(const uint8_t* data, uint16_t count)
+{
+	uint16_t written = 0;
+
+	while (written < count)
+	{
+		uint8_t* span_data;
+		uint16_t span = getWriteSpan(span_data);
+		if (!span)
+		{
+			Stalls++;
+			break;
+		}
+
+		if (span > count - written)
+			span = count - written;
+
+		memcpy(span_data, data + written, span);
+		commitWrite(span);
+		written += span;
+	}
+
+	return written;
+}
+
+#if defined(ARDUINO)
+
+uint16_t MAXStreamPlayer_Base::poll(Stream& stream)
+{
+	uint16_t total = 0;
+
+	//at most a ring's worth per call, so a fast link can't hold up the loop
+	while (total <= RingMask)
+	{
+		int available = stream.available();
+		if (available <= 0)
+			break;
+
+		//StreamLatest makes room rather than hold the link back
+		bool applied;
+		if (!getFree() && Policy == StreamLatest)
+			while (processPacket(applied));
+
+		uint8_t* data;
+		uint16_t span = getWriteSpan(data);
+		if (!span)
+		{
+			Stalls++;
+			break;
+		}
+
+		if (span > available)
+			span = available;
+
+		//straight from the serial buffer into the ring
+		uint16_t count = stream.readBytes((char*)data, span);
+		commitWrite(count);
+		total += count;
+
+		if (count < span)
+			break;
+	}
+
+	return total;
+}
+
+#else
+
+uint16_t MAXStreamPlayer_Base::poll(FILE* file)
+{
+	uint16_t total = 0;
+
+	//at most a ring's worth per call, so a fast source can't hold up the loop
+	while (total <= RingMask)
+	{
+		//StreamLatest makes room rather than hold the source back
+		bool applied;
+		if (!getFree() && Policy == StreamLatest)
+			while (processPacket(applied));
+
+		uint8_t* data;
+		uint16_t span = getWriteSpan(data);
+		if (!span)
+		{
+			Stalls++;
+			break;
+		}
+
+		//straight from the file or pipe into the ring
+		uint16_t count = fread(data, 1, span, file);
+		commitWrite(count);
+		total += count;
+
+		if (count < span)
+			break;
+	}
+
+	return total;
+}
+
+#endif
+
+bool MAXStreamPlayer_Base::update()
+{
+	bool changed = false;
+	bool applied;
+
+	if (Policy == StreamBackpressure)
+	{
+		//a hidden layer never draws, take its frame here rather than stall the stream
+		if (FramePending && isHidden())
+		{
+			FramesDropped++;
+			FramePending = false;
+		}
+
+		//one frame, once the previous one has been taken
+		while (!FramePending && processPacket(applied))
+			changed |= applied;
+	}
+	else
+	{
+		while (processPacket(applied))
+			changed |= applied;
+	}
+
+	return changed;
+}
+
+void MAXStreamPlayer_Base::resetStats()
+{
+	BytesReceived = 0;
+	FramesReceived = 0;
+	FramesShown = 0;
+	FramesDropped = 0;
+	BadPackets = 0;
+	BytesDiscarded = 0;
+	Stalls = 0;
+	MaxUsed = 0;
+}
+
+void MAXStreamPlayer_Base::acknowledgeFrame()
+{
+	if (FramePending)
+	{
+		FramesShown++;
+		FramePending = false;
+	}
+}
+
+void MAXStreamPlayer_Base::draw(MAXBitmap& frame, uint8_t blend)
+{
+	acknowledgeFrame();
+	frame.blit(Picture, PositionX, PositionY, blend);
+}
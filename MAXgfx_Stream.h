@@ -0,0 +1,165 @@
+// MAXgfx_Stream.h
+
+#ifndef _MAX72XX_GFX_STREAM_h
+#define _MAX72XX_GFX_STREAM_h
+
+#include "MAXgfx.h"
+
+//packet framing: sync, flags, sequence, payload length (2 bytes, little endian), payload, checksum
+#define MAXSTREAM_SYNC 0xA5
+#define MAXSTREAM_HEADER_SIZE 5
+#define MAXSTREAM_KEYFRAME 0x01
+
+//span first row is one byte, so pictures are at most this many rows tall
+#define MAXSTREAM_MAX_ROWS 256
+
+/** Frame stream protocol.
+ *  A packet carries one frame as spans of whole picture rows: first row, row count, then count rows of stride bytes
+ *  (MSB = left pixel). Keyframes carry every row, other frames only the rows that changed since the previous frame.
+ *  Sequence numbers increase by one per frame, the checksum makes the 8-bit sum of every byte after sync zero. */
+namespace MAXStream
+{
+	//packet for frame, delta against previous (NULL or keyframe set sends every row), returns packet size
+	//(0 if output is too small or rows is over MAXSTREAM_MAX_ROWS)
+	uint16_t encodeFrame(const uint8_t* frame, const uint8_t* previous, uint16_t stride, uint16_t rows, uint8_t sequence, bool keyframe, uint8_t* output, uint16_t max_size);
+}
+
+/** Plays a frame stream as a display layer.
+ *  Received bytes go into a ring buffer, either written straight into it by the reader (getWriteSpan/commitWrite,
+ *  poll) or copied in (write). Packets are checked in the ring and their rows copied from it into the picture, which
+ *  the layer draws: delta frames only carry changed rows, so the picture has to outlive the packet.
+ *  A lost or corrupt packet drops frames until the next keyframe, so the picture never misses a change.
+ *  Policy when frames arrive faster than they're drawn:
+ *   StreamBackpressure  apply a frame only once the previous one has been taken. The ring fills up, poll stops
+ *                       reading and the link (serial buffer, pipe) holds the sender back. Every frame is shown
+ *                       while the layer is visible
+ *   StreamLatest        apply every complete frame, showing the newest. poll makes room by applying frames rather
+ *                       than stop reading, so the sender never waits and frames that were never shown are dropped
+ *  A frame is taken when the layer draws it. A player whose picture is used some other way (not a display layer,
+ *  or not composited) must call acknowledgeFrame() once it has used it, or backpressure never lets the next one in.
+ *  While the layer is hidden, update() takes frames itself (counted as dropped) so the stream keeps flowing. */
+class MAXStreamPlayer_Base : public MAXDrawable
+{
+
+public:
+
+	enum enumPolicy : uint8_t {
+		StreamBackpressure,
+		StreamLatest
+	};
+
+protected:
+
+	//ring buffer (storage owned by derived class), RingSize a power of 2, one byte always left free
+	uint8_t* Ring;
+	uint16_t RingMask;
+	uint16_t Head = 0;
+	uint16_t Tail = 0;
+
+	//picture drawn by the layer (storage owned by derived class)
+	MAXBitmap Picture;
+	int PositionX = 0;
+	int PositionY = 0;
+
+	uint8_t Policy = StreamBackpressure;
+
+	//stream state
+	bool WaitKeyframe = true;
+	uint8_t NextSequence = 0;
+	bool FramePending = false;
+
+	//statistics
+	uint32_t BytesReceived = 0;
+	uint32_t FramesReceived = 0;
+	uint32_t FramesShown = 0;
+	uint32_t FramesDropped = 0;
+	uint32_t BadPackets = 0;
+	uint32_t BytesDiscarded = 0;
+	uint32_t Stalls = 0;
+	uint16_t MaxUsed = 0;
+
+	MAXStreamPlayer_Base(uint8_t* ring, uint16_t ring_size, uint8_t* picture_data, uint16_t width, uint16_t height);
+
+	//ring access relative to Tail
+	uint8_t peek(uint16_t offset) { return Ring[(Tail + offset) & RingMask]; }
+	void copyOut(uint16_t offset, uint8_t* destination, uint16_t count);
+	void discard(uint16_t count) { Tail = (Tail + count) & RingMask; }
+
+	//check or apply the spans of the payload of the packet at Tail
+	bool applySpans(uint16_t length, bool check);
+
+	//handle the packet at Tail, returns false when no complete packet is waiting.
+	//applied is set when a frame made it to the picture
+	bool processPacket(bool& applied);
+
+public:
+
+	//receive side: contiguous free space in the ring to read into, then commit what was read
+	uint16_t getWriteSpan(uint8_t*& data);
+	void commitWrite(uint16_t count);
+
+	//copy bytes in, returns bytes taken (less than count when the ring is full)
+	uint16_t write(const uint8_t* data, uint16_t count);
+
+	//read what the source has into the ring (StreamLatest applies frames to make room), returns bytes read
+#if defined(ARDUINO)
+	uint16_t poll(Stream& stream);
+#else
+	uint16_t poll(FILE* file);
+#endif
+
+	//apply received frames per policy, call once per display frame before compositing. Returns true if the picture changed
+	bool update();
+
+	//the picture's current frame has been used (draw does this), lets backpressure apply the next one
+	void acknowledgeFrame();
+	bool isFramePending() { return FramePending; }
+
+	//settings
+	void setPolicy(uint8_t policy) { Policy = policy; }
+	uint8_t getPolicy() { return Policy; }
+	void setPosition(int position_x, int position_y) { PositionX = position_x; PositionY = position_y; }
+
+	//decoded picture, and start over waiting for a keyframe
+	MAXBitmap& getPicture() { return Picture; }
+	void resync() { Head = Tail = 0; WaitKeyframe = true; FramePending = false; }
+
+	//ring state
+	uint16_t getRingSize() { return RingMask + 1; }
+	uint16_t getUsed() { return (Head - Tail) & RingMask; }
+	uint16_t getFree() { return RingMask - getUsed(); }
+
+	//statistics: frames received = applied to the picture, dropped = never shown (superseded or lost to a resync),
+	//stalls = reads cut short by a full ring (link held back), max used = ring high water mark
+	uint32_t getBytesReceived() { return BytesReceived; }
+	uint32_t getFramesReceived() { return FramesReceived; }
+	uint32_t getFramesShown() { return FramesShown; }
+	uint32_t getFramesDropped() { return FramesDropped; }
+	uint32_t getBadPackets() { return BadPackets; }
+	uint32_t getBytesDiscarded() { return BytesDiscarded; }
+	uint32_t getStalls() { return Stalls; }
+	uint16_t getMaxUsed() { return MaxUsed; }
+	void resetStats();
+
+	void draw(MAXBitmap& frame, uint8_t blend);
+};
+
+/** Stream player with a WIDTH x HEIGHT picture and a RING_SIZE byte receive ring
+ *  (power of 2, larger than a keyframe packet: stride x HEIGHT + 2 bytes per 255 rows + 6) */
+template <uint16_t WIDTH, uint16_t HEIGHT, uint16_t RING_SIZE = 256>
+class MAXStreamPlayer : public MAXStreamPlayer_Base
+{
+	static_assert(RING_SIZE >= 16 && (RING_SIZE & (RING_SIZE - 1)) == 0, "ring size must be a power of 2");
+	static_assert(HEIGHT <= MAXSTREAM_MAX_ROWS, "stream rows are addressed with one byte");
+
+protected:
+
+	uint8_t RingData[RING_SIZE];
+	uint8_t PictureData[((WIDTH + 7) / 8) * HEIGHT];
+
+public:
+
+	MAXStreamPlayer() : MAXStreamPlayer_Base(RingData, RING_SIZE, PictureData, WIDTH, HEIGHT), PictureData() {}
+};
+
+#endif
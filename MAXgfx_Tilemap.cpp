@@ -0,0 +1,98 @@
+//
+//
+//
+
+#include "MAXgfx_Tilemap.h"
+
+bool MAXTilemap::wrapCoordinate(int& position, int size, bool wrap)
+{
+	if (wrap)
+	{
+		position = ((position % size) + size) % size;
+		return true;
+	}
+
+	return position >= 0 && position < size;
+}
+
+uint8_t MAXTilemap::getTile(int col, int row)
+{
+	if (!Map || !wrapCoordinate(col, MapCols, WrapX) || !wrapCoordinate(row, MapRows, WrapY))
+		return MAXTILE_NONE;
+
+	return readMap(row * MapCols + col);
+}
+
+void MAXTilemap::setTile(uint8_t col, uint8_t row, uint8_t tile)
+{
+	if (!Map || MapProgmem || col >= MapCols || row >= MapRows)
+		return;
+
+	//map was given as RAM
+	const_cast<uint8_t*>(Map)[row * MapCols + col] = tile;
+}
+
+void MAXTilemap::draw(MAXBitmap& frame, uint8_t blend)
+{
+	if (!Map || !Tiles || !MapCols || !MapRows)
+		return;
+
+	//window clipped to the framebuffer
+	int left = PositionX < 0 ? 0 : PositionX;
+	int top = PositionY < 0 ? 0 : PositionY;
+	int right = WindowWidth ? PositionX + WindowWidth : frame.getWidth();
+	int bottom = WindowHeight ? PositionY + WindowHeight : frame.getHeight();
+	if (right > frame.getWidth()) right = frame.getWidth();
+	if (bottom > frame.getHeight()) bottom = frame.getHeight();
+
+	if (left >= right || top >= bottom)
+		return;
+
+	//first and last framebuffer byte of each row and the part of them inside the window
+	uint16_t first = left >> 3;
+	uint16_t last = (right - 1) >> 3;
+	uint8_t first_mask = 0xFF >> (left & 0x07);
+	uint8_t last_mask = 0xFF << (7 - ((right - 1) & 0x07));
+
+	//map x at the left edge of the first byte, as tile column and sub-tile offset (floor for negative x)
+	int start_x = ViewX - PositionX + first * MATRIX_DIM;
+	wrapCoordinate(start_x, getMapWidth(), WrapX);
+	int start_col = start_x >> 3;
+	uint8_t shift = start_x & 0x07;
+
+	for (int y = top; y < bottom; y++)
+	{
+		int map_y = ViewY + y - PositionY;
+		bool inside = wrapCoordinate(map_y, getMapHeight(), WrapY);
+
+		//blank row only changes the framebuffer when drawn opaque
+		if (!inside && blend != BlendOpaque)
+			continue;
+
+		uint8_t* row_data = frame.getRow(y);
+		uint16_t map_offset = inside ? (map_y >> 3) * MapCols : 0;
+		uint8_t tile_row = map_y & 0x07;
+
+		//one tile row read per byte: the tile under its right half becomes the next byte's left half
+		int col = start_col;
+		uint8_t left_bits = inside ? getTileRow(map_offset, col, tile_row) : 0x00;
+
+		for (uint16_t i = first; i <= last; i++)
+		{
+			if (++col == MapCols && WrapX)
+				col = 0;
+
+			uint8_t right_bits = inside ? getTileRow(map_offset, col, tile_row) : 0x00;
+			uint8_t bits = shift ? (left_bits << shift) | (right_bits >> (MATRIX_DIM - shift)) : left_bits;
+			left_bits = right_bits;
+
+			uint8_t mask = 0xFF;
+			if (i == first)
+				mask &= first_mask;
+			if (i == last)
+				mask &= last_mask;
+
+			MAXBlendByte(row_data + i, bits & mask, mask, blend);
+		}
+	}
+}
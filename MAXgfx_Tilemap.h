@@ -0,0 +1,102 @@
+// MAXgfx_Tilemap.h
+
+#ifndef _MAX72XX_GFX_TILEMAP_h
+#define _MAX72XX_GFX_TILEMAP_h
+
+#include "MAXgfx.h"
+
+//no tile (outside the map, or index past the end of the tile set)
+#define MAXTILE_NONE 0xFF
+
+/** Level made of 8x8 tiles, drawn as a display layer through a scrolling window.
+ *  The map is a grid of one byte tile indexes (row-major, up to 254 tiles), the tile set holds MATRIX_DIM bytes per
+ *  tile in the same layout as sprite data (MSB = left pixel). Either can be in RAM or flash.
+ *  Each framebuffer byte is built from the two tiles it straddles, shifted by the view's sub-tile offset, and each
+ *  tile row is read once per display row, so a frame costs the same for any map size. The map can wrap around in
+ *  either direction for endless levels, outside it (not wrapping) is blank. */
+class MAXTilemap : public MAXDrawable
+{
+
+protected:
+
+	//tile set
+	const uint8_t* Tiles = NULL;
+	uint8_t TileCount = 0;
+	bool TilesProgmem = false;
+
+	//map of tile indexes
+	const uint8_t* Map = NULL;
+	uint8_t MapCols = 0;
+	uint8_t MapRows = 0;
+	bool MapProgmem = false;
+
+	//top left corner of the view in map pixels
+	int ViewX = 0;
+	int ViewY = 0;
+
+	//window on the display (size 0 = to the edge of the framebuffer)
+	int PositionX = 0;
+	int PositionY = 0;
+	uint16_t WindowWidth = 0;
+	uint16_t WindowHeight = 0;
+
+	bool WrapX = false;
+	bool WrapY = false;
+
+	uint8_t readMap(uint16_t index) { return MapProgmem ? pgm_read_byte(Map + index) : Map[index]; }
+	uint8_t readTile(uint16_t index) { return TilesProgmem ? pgm_read_byte(Tiles + index) : Tiles[index]; }
+
+	//row of the tile at column col of the map row starting at map_offset, 0 outside the map or past the tile set
+	uint8_t getTileRow(uint16_t map_offset, int col, uint8_t row)
+	{
+		if (col < 0 || col >= MapCols)
+			return 0x00;
+
+		uint8_t tile = readMap(map_offset + col);
+		return tile < TileCount ? readTile(tile * MATRIX_DIM + row) : 0x00;
+	}
+
+	//map coordinate wrapped into 0 - size, false if outside and not wrapping
+	static bool wrapCoordinate(int& position, int size, bool wrap);
+
+public:
+
+	MAXTilemap() {}
+	MAXTilemap(const uint8_t* tiles, uint8_t tile_count, const uint8_t* map, uint8_t map_cols, uint8_t map_rows, bool progmem = false)
+	{
+		setTiles(tiles, tile_count, progmem);
+		setMap(map, map_cols, map_rows, progmem);
+	}
+
+	//tile set and map, read in place from RAM or flash (progmem set)
+	void setTiles(const uint8_t* tiles, uint8_t tile_count, bool progmem = false) { Tiles = tiles; TileCount = tile_count; TilesProgmem = progmem; }
+	void setMap(const uint8_t* map, uint8_t map_cols, uint8_t map_rows, bool progmem = false) { Map = map; MapCols = map_cols; MapRows = map_rows; MapProgmem = progmem; }
+
+	//map size
+	uint8_t getMapCols() { return MapCols; }
+	uint8_t getMapRows() { return MapRows; }
+	int getMapWidth() { return MapCols * MATRIX_DIM; }
+	int getMapHeight() { return MapRows * MATRIX_DIM; }
+
+	//tile index at a map cell, or under a map pixel (wrapped if wrapping), MAXTILE_NONE outside the map
+	uint8_t getTile(int col, int row);
+	uint8_t getTileAt(int map_x, int map_y) { return getTile(map_x >> 3, map_y >> 3); }
+
+	//change a map cell (map in RAM only)
+	void setTile(uint8_t col, uint8_t row, uint8_t tile);
+
+	//view position in map pixels
+	void setView(int view_x, int view_y) { ViewX = view_x; ViewY = view_y; }
+	void moveView(int distance_x, int distance_y) { ViewX += distance_x; ViewY += distance_y; }
+	int getViewX() { return ViewX; }
+	int getViewY() { return ViewY; }
+
+	//window on the display the map is drawn in (width or height 0 = to the edge of the framebuffer)
+	void setWindow(int position_x, int position_y, uint16_t width = 0, uint16_t height = 0) { PositionX = position_x; PositionY = position_y; WindowWidth = width; WindowHeight = height; }
+
+	void setWrap(bool wrap_x, bool wrap_y) { WrapX = wrap_x; WrapY = wrap_y; }
+
+	void draw(MAXBitmap& frame, uint8_t blend);
+};
+
+#endif
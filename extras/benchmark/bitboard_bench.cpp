@@ -0,0 +1,212 @@
+// bitboard_bench.cpp
+//
+// Host benchmark: byte-loop matrix helpers (as originally in MAXgfx.cpp) vs the 64-bit kernels in MAXgfx_Bitboard.h
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. extras/benchmark/bitboard_bench.cpp -o bitboard_bench && ./bitboard_bench
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAXgfx_Bitboard.h"
+
+#define MATRIX_DIM 8
+
+namespace Reference
+{
+	void ClearMatrix(uint8_t* input, bool invert = false)
+	{
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			if (invert)
+				*(input + i) = 0xFF;
+			else
+				*(input + i) = 0x00;
+	}
+
+	void CopyMatrix(const uint8_t* input, uint8_t* output)
+	{
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			*(output + i) = *(input + i);
+	}
+
+	void OrMatrix(uint8_t* input1_result, const uint8_t* input2)
+	{
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			*(input1_result + i) |= *(input2 + i);
+	}
+
+	void TransposeMatrix(uint8_t* input, int move_x, int move_y)
+	{
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+		{
+			if (abs(move_x) >= MATRIX_DIM)
+				input[i] = 0x00;
+			else
+			{
+				if (move_x > 0)
+					*(input + i) >>= move_x;
+				else if (move_x < 0)
+					*(input + i) <<= abs(move_x);
+			}
+		}
+
+		if (move_y)
+		{
+			uint8_t temp[8];
+
+			for (uint8_t i = 0; i < MATRIX_DIM; i++)
+			{
+				if (abs(move_y) >= MATRIX_DIM)
+					temp[i] = 0x00;
+				else
+				{
+					if (i - move_y >= 0 && i - move_y < MATRIX_DIM)
+						*(temp + i) = *(input + i - move_y);
+					else *(temp + i) = 0x00;
+				}
+			}
+
+			CopyMatrix(temp, input);
+		}
+	}
+
+	void MaskMatrix(uint8_t* input, uint8_t size_x, uint8_t size_y)
+	{
+		for (uint8_t i = 0; i < MATRIX_DIM; i++)
+		{
+			if (i < size_y)
+				*(input + i) &= (uint8_t)(0xFF << (MATRIX_DIM - size_x));
+			else
+				*(input + i) = 0x00;
+		}
+	}
+
+	void OrBuffer(uint8_t* input1_result, const uint8_t* input2, uint16_t length)
+	{
+		for (uint16_t i = 0; i < length; i++)
+			input1_result[i] |= input2[i];
+	}
+}
+
+namespace Bitboard
+{
+	using namespace MAXBitboard;
+
+	void ClearMatrix(uint8_t* input) { store(0, input); }
+	void OrMatrix(uint8_t* a, const uint8_t* b) { store(load(a) | load(b), a); }
+	void TransposeMatrix(uint8_t* input, int move_x, int move_y) { store(shift(load(input), move_x, move_y), input); }
+	void MaskMatrix(uint8_t* input, uint8_t size_x, uint8_t size_y) { store(load(input) & rectMask(size_x, size_y), input); }
+
+	void OrBuffer(uint8_t* input1_result, const uint8_t* input2, uint16_t length)
+	{
+		uint16_t i = 0;
+		for (; i + 8 <= length; i += 8)
+			store(load(input1_result + i) | load(input2 + i), input1_result + i);
+		for (; i < length; i++)
+			input1_result[i] |= input2[i];
+	}
+}
+
+namespace
+{
+	//keeps the optimiser from discarding benchmark results
+	volatile uint8_t Sink;
+
+	const long ITERATIONS = 4000000;
+
+	uint8_t Sprite[MATRIX_DIM] = { 0x3C, 0x42, 0xA5, 0x81, 0xA5, 0x99, 0x42, 0x3C };
+
+	template <typename F>
+	double time_ns(F f)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long i = 0; i < ITERATIONS; i++)
+			f(i);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+	}
+
+	void report(const char* name, double reference_ns, double bitboard_ns)
+	{
+		printf("%-28s %8.2f ns %8.2f ns %6.1fx\n", name, reference_ns, bitboard_ns, reference_ns / bitboard_ns);
+	}
+
+	//render pipeline as used by MAXSprite::updateDisplayData
+	template <typename CLEAR, typename COPY, typename MASK, typename MOVE>
+	double time_render(CLEAR clear, COPY copy, MASK mask, MOVE move)
+	{
+		uint8_t display[MATRIX_DIM];
+		return time_ns([&](long i)
+		{
+			clear(display);
+			copy(Sprite, display);
+			mask(display, 1 + (i & 7), 1 + ((i >> 3) & 7));
+			move(display, (int)(i % 19) - 9, (int)(i % 17) - 8);
+			Sink = display[i & 7];
+		});
+	}
+
+	bool check_equivalence()
+	{
+		for (int x = -9; x <= 9; x++)
+			for (int y = -9; y <= 9; y++)
+				for (uint8_t w = 1; w < MATRIX_DIM; w++)
+				{
+					uint8_t a[MATRIX_DIM], b[MATRIX_DIM];
+					Reference::CopyMatrix(Sprite, a);
+					Reference::CopyMatrix(Sprite, b);
+					Reference::MaskMatrix(a, w, MATRIX_DIM - w);
+					Reference::TransposeMatrix(a, x, y);
+					Bitboard::MaskMatrix(b, w, MATRIX_DIM - w);
+					Bitboard::TransposeMatrix(b, x, y);
+					if (memcmp(a, b, MATRIX_DIM))
+					{
+						printf("mismatch at x=%d y=%d w=%d\n", x, y, w);
+						return false;
+					}
+				}
+		return true;
+	}
+}
+
+int main()
+{
+	if (!check_equivalence())
+		return 1;
+
+	printf("%-28s %11s %11s %7s\n", "kernel", "byte loop", "bitboard", "speedup");
+
+	uint8_t a[MATRIX_DIM] = { 0 };
+
+	report("ClearMatrix",
+		time_ns([&](long i) { Reference::ClearMatrix(a); Sink = a[i & 7]; }),
+		time_ns([&](long i) { Bitboard::ClearMatrix(a); Sink = a[i & 7]; }));
+
+	report("OrMatrix",
+		time_ns([&](long i) { Reference::OrMatrix(a, Sprite); Sink = a[i & 7]; }),
+		time_ns([&](long i) { Bitboard::OrMatrix(a, Sprite); Sink = a[i & 7]; }));
+
+	report("MaskMatrix",
+		time_ns([&](long i) { Reference::CopyMatrix(Sprite, a); Reference::MaskMatrix(a, 1 + (i & 7), 1 + ((i >> 3) & 7)); Sink = a[i & 7]; }),
+		time_ns([&](long i) { Reference::CopyMatrix(Sprite, a); Bitboard::MaskMatrix(a, 1 + (i & 7), 1 + ((i >> 3) & 7)); Sink = a[i & 7]; }));
+
+	report("TransposeMatrix",
+		time_ns([&](long i) { Reference::CopyMatrix(Sprite, a); Reference::TransposeMatrix(a, (int)(i % 19) - 9, (int)(i % 17) - 8); Sink = a[i & 7]; }),
+		time_ns([&](long i) { Reference::CopyMatrix(Sprite, a); Bitboard::TransposeMatrix(a, (int)(i % 19) - 9, (int)(i % 17) - 8); Sink = a[i & 7]; }));
+
+	report("sprite render pipeline",
+		time_render([](uint8_t* m) { Reference::ClearMatrix(m); }, Reference::CopyMatrix, Reference::MaskMatrix, Reference::TransposeMatrix),
+		time_render(Bitboard::ClearMatrix, [](const uint8_t* i, uint8_t* o) { memcpy(o, i, MATRIX_DIM); }, Bitboard::MaskMatrix, Bitboard::TransposeMatrix));
+
+	//OR of two 32 module framebuffers
+	static uint8_t frame1[32 * MATRIX_DIM], frame2[32 * MATRIX_DIM];
+	for (uint16_t i = 0; i < sizeof(frame2); i++)
+		frame2[i] = (uint8_t)(i * 37);
+
+	report("OrBuffer (32 modules)",
+		time_ns([&](long i) { Reference::OrBuffer(frame1, frame2, sizeof(frame1)); Sink = frame1[i & 255]; }),
+		time_ns([&](long i) { Bitboard::OrBuffer(frame1, frame2, sizeof(frame1)); Sink = frame1[i & 255]; }));
+
+	return 0;
+}
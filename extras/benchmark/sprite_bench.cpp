@@ -0,0 +1,464 @@
+// sprite_bench.cpp
+//
+// Host benchmark: sprite pipeline and compositor under typical scenes (8 sprites moving, animating, colliding),
+// output through MAXDriver_Sim so bytes sent per frame are counted as well as compute time.
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/benchmark/sprite_bench.cpp -o sprite_bench && ./sprite_bench [host GHz]
+//
+// Target cycle estimates are host cycles scaled by a per-target factor plus SPI time at the target's SPI clock.
+// The scale factors are rough assumptions (8-bit core, no barrel shifter on AVR; in-order 32-bit core on Cortex-M),
+// use them to compare runs with each other, not as a cycle-accurate prediction.
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Shapes.h"
+#include "MAXgfx_SpatialIndex.h"
+#include "MAXgfx_Delta.h"
+#include "MAXgfx_Particles.h"
+#include "MAXgfx_Tilemap.h"
+
+namespace
+{
+	struct Target
+	{
+		const char* Name;
+		double CpuHz;
+		double SpiHz;
+		double HostCycleScale;
+	};
+
+	const Target Targets[] =
+	{
+		{ "AVR@16MHz", 16e6, 8e6, 12.0 },
+		{ "M4@72MHz", 72e6, 9e6, 2.5 },
+	};
+
+	const long ITERATIONS = 200000;
+
+	//keeps the optimiser from discarding benchmark results
+	volatile uint8_t Sink;
+
+	double HostGHz = 3.0;
+
+	const uint8_t Smiley[MATRIX_DIM] = { 0x3C, 0x42, 0xA5, 0x81, 0xA5, 0x99, 0x42, 0x3C };
+
+	//4 frame spinner, frames stored back to back
+	uint8_t Spinner[4][MATRIX_DIM] =
+	{
+		{ 0x18, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00 },
+		{ 0x03, 0x06, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00 },
+		{ 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00 },
+		{ 0xC0, 0x60, 0x30, 0x18, 0x00, 0x00, 0x00, 0x00 },
+	};
+
+	template <typename F>
+	double time_ns(F f)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long i = 0; i < ITERATIONS; i++)
+			f(i);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+	}
+
+	void header()
+	{
+		printf("%-38s %10s %8s %9s", "benchmark", "ns/op", "bytes/op", "bus us/op");
+		for (uint8_t i = 0; i < sizeof(Targets) / sizeof(Targets[0]); i++)
+			printf(" %12s", Targets[i].Name);
+		printf("\n");
+	}
+
+	void report(const char* name, double ns, double bytes)
+	{
+		printf("%-38s %10.1f %8.1f %9.2f", name, ns, bytes, bytes * 8 / 10e6 * 1e6);
+
+		//estimated target cycles: scaled compute + SPI transfer at target's SPI clock
+		for (uint8_t i = 0; i < sizeof(Targets) / sizeof(Targets[0]); i++)
+		{
+			double cycles = ns * HostGHz * Targets[i].HostCycleScale + bytes * 8 * Targets[i].CpuHz / Targets[i].SpiHz;
+			printf(" %12.0f", cycles);
+		}
+		printf("\n");
+	}
+
+	//8 sprites spread over the display
+	void place_sprites(MAXgfx_Base& gfx, MAXSprite* sprites, uint8_t count)
+	{
+		for (uint8_t i = 0; i < count; i++)
+		{
+			sprites[i].initSprite(Smiley, 3 + (i % 3), 3 + (i % 4), (i * 5) % gfx.getDisplayWidth(), (i * 3) % MATRIX_DIM);
+			gfx.addSprite(sprites[i]);
+		}
+	}
+
+	template <typename GFX>
+	void bench_compositor(const char* name, bool moving)
+	{
+		MAXDriver_Sim driver;
+		GFX gfx(driver);
+		MAXSprite sprites[SPRITE_LOCATION_CNT];
+
+		gfx.init();
+		place_sprites(gfx, sprites, SPRITE_LOCATION_CNT);
+		gfx.updateDisplay();
+		driver.resetCounters();
+
+		double ns = time_ns([&](long i)
+		{
+			if (moving)
+			{
+				//sweep back and forth across the display
+				int step = ((i / gfx.getDisplayWidth()) & 1) ? -1 : 1;
+				for (uint8_t s = 0; s < SPRITE_LOCATION_CNT; s++)
+					sprites[s].move(step, 0);
+			}
+			gfx.updateDisplay();
+		});
+
+		report(name, ns, (double)driver.getBytesWritten() / ITERATIONS);
+	}
+
+	void bench_render()
+	{
+		MAXSprite sprite(Smiley, 6, 5, 0, 0);
+
+		double ns = time_ns([&](long i)
+		{
+			//moving sprite, re-render on every read
+			sprite.setPosition((int)(i % 19) - 9, (int)(i % 17) - 8);
+			Sink = sprite.getDisplayData()[i & 7];
+		});
+		report("MAXSprite::updateDisplayData", ns, 0);
+
+		ns = time_ns([&](long i)
+		{
+			//static sprite, cached render
+			Sink = sprite.getDisplayRow(i & 7);
+		});
+		report("MAXSprite::getDisplayRow (cached)", ns, 0);
+	}
+
+	void bench_animation()
+	{
+		MAXDriver_Sim driver;
+		MAXgfx gfx(driver);
+		MAXSprite_MultiFrame* sprites[SPRITE_LOCATION_CNT];
+
+		gfx.init();
+		for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+		{
+			sprites[i] = new MAXSprite_MultiFrame((uint8_t**)Spinner, 4, 5, 4, i - 4, i - 4);
+			gfx.addSprite(*sprites[i]);
+		}
+		gfx.updateDisplay();
+		driver.resetCounters();
+
+		double ns = time_ns([&](long)
+		{
+			for (uint8_t s = 0; s < SPRITE_LOCATION_CNT; s++)
+				sprites[s]->nextFrame();
+		});
+		report("MAXSprite_MultiFrame::nextFrame x8", ns, 0);
+
+		ns = time_ns([&](long)
+		{
+			for (uint8_t s = 0; s < SPRITE_LOCATION_CNT; s++)
+				sprites[s]->nextFrame();
+			gfx.updateDisplay();
+		});
+		report("animate x8 + updateDisplay", ns, (double)driver.getBytesWritten() / ITERATIONS);
+
+		//same spinner, compressed
+		uint8_t encoded[64];
+		MAXDelta::encode((const uint8_t*)Spinner, 4, 4, encoded, sizeof(encoded));
+		MAXSprite_Delta deltas[SPRITE_LOCATION_CNT];
+		for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+			deltas[i].initAnimation(encoded, 5, 4, false, i - 4, i - 4);
+
+		ns = time_ns([&](long)
+		{
+			for (uint8_t s = 0; s < SPRITE_LOCATION_CNT; s++)
+				deltas[s].nextFrame();
+		});
+		report("MAXSprite_Delta::nextFrame x8", ns, 0);
+
+		for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+			delete sprites[i];
+	}
+
+	void bench_collision()
+	{
+		MAXSprite sprites[SPRITE_LOCATION_CNT];
+		for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+			sprites[i].initSprite(Smiley, 2, 2, (i * 2) % MATRIX_DIM, (i / 4) * 2);
+
+		double ns = time_ns([&](long i)
+		{
+			//every pair, every frame
+			uint8_t touching = 0;
+			for (uint8_t a = 0; a < SPRITE_LOCATION_CNT; a++)
+				for (uint8_t b = a + 1; b < SPRITE_LOCATION_CNT; b++)
+					touching |= sprites[a].isTouchingSprite(sprites[b]);
+			sprites[i & 7].move((i & 8) ? -1 : 1, 0);
+			Sink = touching;
+		});
+		report("isTouchingSprite all 28 pairs", ns, 0);
+
+		MAXDriver_Sim driver;
+		MAXgfx gfx(driver);
+		SpriteCollision collisions[28];
+		for (uint8_t i = 0; i < SPRITE_LOCATION_CNT; i++)
+			gfx.addSprite(sprites[i]);
+
+		ns = time_ns([&](long i)
+		{
+			sprites[i & 7].move((i & 8) ? -1 : 1, 0);
+			Sink = gfx.findCollisions(collisions, 28);
+		});
+		report("findCollisions all 28 pairs", ns, 0);
+	}
+
+	//64 small sprites wandering over an 8x4 chain: neighbours of one sprite, every overlapping pair
+	void bench_spatial_index()
+	{
+		const uint8_t COUNT = 64;
+		MAXSprite sprites[COUNT];
+		MAXSpatialIndex<8, 4, COUNT> index;
+		MAXSprite* results[COUNT];
+		MAXSpritePair pairs[COUNT * 4];
+
+		for (uint8_t i = 0; i < COUNT; i++)
+		{
+			sprites[i].initSprite(Smiley, 3, 3, (i * 37) % 64, (i * 13) % 32);
+			index.addSprite(sprites[i]);
+		}
+
+		double ns = time_ns([&](long i)
+		{
+			sprites[i & 63].move((i & 64) ? -1 : 1, (i & 128) ? -1 : 1);
+			Sink = index.queryOverlapping(sprites[(i + 32) & 63], results, COUNT);
+		});
+		report("MAXSpatialIndex queryOverlapping, 64", ns, 0);
+
+		ns = time_ns([&](long i)
+		{
+			//brute force equivalent
+			sprites[i & 63].move((i & 64) ? -1 : 1, (i & 128) ? -1 : 1);
+			MAXSprite& sprite = sprites[(i + 32) & 63];
+			uint8_t found = 0;
+			for (uint8_t s = 0; s < COUNT; s++)
+				found += &sprites[s] != &sprite && MAXgfx_Base::isOverlapping(sprite, sprites[s]);
+			Sink = found;
+		});
+		report("isOverlapping against all 64", ns, 0);
+
+		ns = time_ns([&](long i)
+		{
+			sprites[i & 63].move((i & 64) ? -1 : 1, (i & 128) ? -1 : 1);
+			Sink = index.findOverlaps(pairs, COUNT * 4);
+		});
+		report("MAXSpatialIndex findOverlaps, 64", ns, 0);
+	}
+
+	//256 particles bouncing around an 8x4 chain, kept alive by re-emitting what leaves
+	void bench_particles()
+	{
+		MAXDriver_Sim driver;
+		MAXgfx_Chain<8, 4> gfx(driver);
+		MAXParticles<256> particles;
+
+		particles.setBounds(gfx.getDisplayWidth(), gfx.getDisplayHeight());
+		particles.setGravity(0, 1);
+		gfx.init();
+		gfx.addLayer(particles);
+
+		double ns = time_ns([&](long)
+		{
+			particles.emitBurst(32, 16, 256 - particles.getCount(), 0, -12, 16, 12, 60, 30);
+			particles.update();
+		});
+		report("MAXParticles update 256", ns, 0);
+
+		ns = time_ns([&](long)
+		{
+			particles.emitBurst(32, 16, 256 - particles.getCount(), 0, -12, 16, 12, 60, 30);
+			particles.update();
+			gfx.composite();
+		});
+		report("MAXParticles update + composite 256", ns, 0);
+	}
+
+	//32 sprites bouncing around an 8x4 chain: move() and edge getters per sprite vs one moveSprites pass
+	void bench_motion()
+	{
+		const uint8_t COUNT = 32;
+		MAXDriver_Sim driver;
+		MAXgfx_Chain<8, 4, COUNT> gfx(driver);
+		MAXSprite sprites[COUNT];
+		int8_t velocity[COUNT][2];
+		SpriteEdgeEvent events[COUNT];
+
+		for (uint8_t i = 0; i < COUNT; i++)
+		{
+			sprites[i].initSprite(Smiley, 3, 3, (i * 37) % 61, (i * 13) % 29, MAXSprite::AllEdges);
+			gfx.addSprite(sprites[i]);
+			velocity[i][0] = 1 + (i % 3);
+			velocity[i][1] = (i & 1) ? 1 : -1;
+		}
+
+		double ns = time_ns([&](long)
+		{
+			//game loop style: move, then poll the edge getters and bounce by hand
+			uint8_t found = 0;
+			for (uint8_t s = 0; s < COUNT; s++)
+			{
+				sprites[s].move(velocity[s][0], velocity[s][1]);
+				if (sprites[s].onMatrixEdge(MAXSprite::LeftEdge) || sprites[s].onMatrixEdge(MAXSprite::RightEdge))
+				{
+					velocity[s][0] = -velocity[s][0];
+					found++;
+				}
+				if (sprites[s].onMatrixEdge(MAXSprite::TopEdge) || sprites[s].onMatrixEdge(MAXSprite::BottomEdge))
+				{
+					velocity[s][1] = -velocity[s][1];
+					found++;
+				}
+			}
+			Sink = found;
+		});
+		report("move + edge getters, 32", ns, 0);
+
+		for (uint8_t i = 0; i < COUNT; i++)
+		{
+			sprites[i].setVelocity(velocity[i][0], velocity[i][1]);
+			sprites[i].setEdgePolicy(MAXSprite::EdgeBounce);
+		}
+
+		ns = time_ns([&](long)
+		{
+			Sink = gfx.moveSprites(events, COUNT);
+		});
+		report("moveSprites bounce, 32", ns, 0);
+	}
+
+	//scrolling tilemap on an 8x4 chain: cost follows the window, not the map
+	void bench_tilemap()
+	{
+		static uint8_t tiles[16 * MATRIX_DIM];
+		static uint8_t map[255 * 64];
+		for (uint16_t i = 0; i < sizeof(tiles); i++)
+			tiles[i] = i * 37;
+		for (uint16_t i = 0; i < sizeof(map); i++)
+			map[i] = (i * 7) & 15;
+
+		MAXDriver_Sim driver;
+		MAXgfx_Chain<8, 4> gfx(driver);
+		MAXTilemap small(tiles, 16, map, 16, 8);
+		MAXTilemap large(tiles, 16, map, 255, 64);
+		small.setWrap(true, true);
+		large.setWrap(true, true);
+
+		double ns = time_ns([&](long i)
+		{
+			small.setView(i, i >> 2);
+			small.draw(gfx.getFrameBuffer(), BlendOpaque);
+		});
+		report("MAXTilemap draw 16x8 map, 8x4", ns, 0);
+
+		ns = time_ns([&](long i)
+		{
+			large.setView(i, i >> 2);
+			large.draw(gfx.getFrameBuffer(), BlendOpaque);
+		});
+		report("MAXTilemap draw 255x64 map, 8x4", ns, 0);
+	}
+
+	//dashboard of 8 bars redrawn every frame without sprites
+	void bench_immediate()
+	{
+		MAXDriver_Sim driver;
+		MAXgfx_Chain<4, 1> gfx(driver);
+
+		gfx.init();
+		double ns = time_ns([&](long i)
+		{
+			gfx.clearFrame();
+			for (uint8_t bar = 0; bar < 8; bar++)
+				gfx.fillRect(bar * 4, 0, 3, 1 + ((i + bar * 3) & 7));
+			gfx.drawLine(0, 7, 31, (i >> 2) & 7);
+			gfx.refresh();
+		});
+		report("immediate 8 fillRect + line, 4x1", ns, (double)driver.getBytesWritten() / ITERATIONS);
+	}
+
+	//whole scene moved one column: framebuffer scroll vs moving every sprite
+	void bench_scroll()
+	{
+		MAXDriver_Sim driver;
+		MAXgfx_Chain<4, 1> gfx(driver);
+		MAXSprite sprites[SPRITE_LOCATION_CNT];
+
+		gfx.init();
+		place_sprites(gfx, sprites, SPRITE_LOCATION_CNT);
+		gfx.updateDisplay();
+		driver.resetCounters();
+
+		double ns = time_ns([&](long)
+		{
+			gfx.scroll(1, 0, true);
+			gfx.refresh();
+		});
+		report("scroll framebuffer 1 column, 4x1", ns, (double)driver.getBytesWritten() / ITERATIONS);
+	}
+
+	void bench_rectangle()
+	{
+		MAXSprite_Rectangle rectangle;
+
+		double ns = time_ns([&](long i)
+		{
+			rectangle.initRectangle(2 + (i % 7), 2 + ((i >> 3) % 7), 1 + (i & 1), i & 2);
+			Sink = rectangle.getWidth();
+		});
+		report("MAXSprite_Rectangle::initRectangle", ns, 0);
+
+		ns = time_ns([&](long i)
+		{
+			//table built by the compiler, only size and position set at runtime
+			MAXSprite_Static<MAXShape_Rectangle<6, 5, 2> > shape(i & 3, 0);
+			Sink = shape.getWidth();
+		});
+		report("MAXSprite_Static<MAXShape_Rectangle>", ns, 0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+		HostGHz = atof(argv[1]);
+
+	printf("host clock assumed %.2f GHz, bus time at 10MHz SPI\n", HostGHz);
+	header();
+
+	bench_render();
+	bench_rectangle();
+	bench_collision();
+	bench_spatial_index();
+	bench_animation();
+	bench_particles();
+	bench_motion();
+	bench_tilemap();
+	bench_immediate();
+	bench_scroll();
+	bench_compositor<MAXgfx>("updateDisplay 8 static", false);
+	bench_compositor<MAXgfx>("updateDisplay 8 moving", true);
+	bench_compositor<MAXgfx_Chain<4, 1> >("updateDisplay 8 moving, 4x1 chain", true);
+	bench_compositor<MAXgfx_Chain<8, 4> >("updateDisplay 8 moving, 8x4 chain", true);
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+// bouncing_sprites.cpp
+//
+// Host example: balls bouncing around a 4x2 chain and a ship wrapping across it, all moved by one moveSprites call a
+// step, printing the edge events as they come and a frame
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/bouncing_sprites.cpp -o bouncing_sprites && ./bouncing_sprites
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+
+namespace
+{
+	const uint8_t Ball[MATRIX_DIM] = { 0x60, 0xF0, 0xF0, 0x60 };
+	const uint8_t Ship[MATRIX_DIM] = { 0x20, 0xF8, 0x20 };
+
+	void printEdges(const char* name, uint8_t edges)
+	{
+		if (!edges)
+			return;
+
+		printf(" %s", name);
+		if (edges & MAXSprite::TopEdge) printf(" top");
+		if (edges & MAXSprite::BottomEdge) printf(" bottom");
+		if (edges & MAXSprite::LeftEdge) printf(" left");
+		if (edges & MAXSprite::RightEdge) printf(" right");
+	}
+}
+
+int main()
+{
+	MAXDriver_Sim driver;
+	MAXgfx_Chain<4, 2> gfx(driver);
+	MAXSprite balls[3];
+	MAXSprite ship;
+	SpriteEdgeEvent events[4];
+
+	gfx.init();
+
+	//balls bounce off every edge
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		balls[i].initSprite(Ball, 4, 4, 4 + i * 9, 2 + i * 4, MAXSprite::AllEdges);
+		balls[i].setEdgePolicy(MAXSprite::EdgeBounce);
+		balls[i].setVelocity(1 + i, (i & 1) ? -1 : 1);
+		gfx.addSprite(balls[i]);
+	}
+
+	//ship flies off the right edge and comes back in on the left
+	ship.initSprite(Ship, 5, 3, 0, 6, MAXSprite::HorizontalEdges);
+	ship.setEdgePolicy(MAXSprite::EdgeWrap);
+	ship.setVelocity(2, 0);
+	gfx.addSprite(ship);
+
+	for (uint8_t step = 0; step < 24; step++)
+	{
+		uint8_t count = gfx.moveSprites(events, 4);
+
+		for (uint8_t i = 0; i < count; i++)
+		{
+			printf("step %2u layer %u:", step, events[i].Layer);
+			printEdges("hit", events[i].Hit);
+			printEdges("on", events[i].OnEdge);
+			printEdges("over", events[i].OverEdge);
+			printEdges("out", events[i].OutOfBounds);
+			printf("\n");
+		}
+
+		gfx.updateDisplay();
+	}
+
+	driver.print(stdout, gfx.getModuleCols());
+	printf("%u bytes (%.1f per frame)\n", driver.getBytesWritten(), driver.getBytesWritten() / 24.0);
+
+	return 0;
+}
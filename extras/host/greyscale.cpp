@@ -0,0 +1,66 @@
+// greyscale.cpp
+//
+// Host example: 4 level greyscale gradient on a 4x1 chain with a 1-bit sprite on top, one subframe per digit scan
+// (or longer when the simulated 10MHz bus and 20us of other work per subframe need it), reporting achieved rates,
+// flicker margin and bus load
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/greyscale.cpp -o greyscale && ./greyscale
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Greyscale.h"
+
+namespace
+{
+	const uint8_t Ball[MATRIX_DIM] = { 0x60, 0xF0, 0xF0, 0x60 };
+}
+
+int main()
+{
+	MAXDriver_Sim driver(10000000, 200);
+	MAXgfx_Chain<4, 1> gfx(driver);
+	MAXGreyscale<32, 8, 2> grey;
+	MAXSprite ball(Ball, 4, 4, 14, 2);
+
+	//8 pixel wide bands, levels 0 - 3
+	for (uint8_t band = 0; band < 4; band++)
+		grey.fillRect(band * 8, 0, 8, 8, band);
+
+	gfx.init();
+	gfx.addLayer(grey);
+	gfx.addLayer(ball, BlendXor);
+	driver.resetCounters();
+
+	//on-time per pixel over one cycle
+	uint8_t on_count[32] = {};
+
+	uint32_t now_us = 0;
+	for (uint16_t i = 0; i < 3000; i++)
+	{
+		grey.nextSubframe(now_us);
+		gfx.updateDisplay();
+
+		if (i < grey.getSubframesPerCycle())
+			for (uint8_t x = 0; x < 32; x++)
+				on_count[x] += driver.getPixel(gfx.getModuleCols(), x, 0);
+
+		//wait out the rest of the scan before the next subframe
+		uint32_t busy_us = (uint32_t)(driver.getLastFrameNs() / 1000) + 20;
+		now_us += busy_us > 1000000UL / MAXGFX_SCAN_HZ ? busy_us : 1000000UL / MAXGFX_SCAN_HZ;
+	}
+
+	printf("row 0 on-time over %u subframes:", grey.getSubframesPerCycle());
+	for (uint8_t x = 0; x < 32; x += 8)
+		printf(" %u", on_count[x]);
+	printf("\n");
+
+	printf("%u subframes/s%s, %u cycles/s (worst case %u), flicker margin %u%% of %u Hz\n",
+		grey.getSubframeRate(), grey.isFasterThanScan() ? " (faster than scan)" : "", grey.getCycleRate(), grey.getMinCycleRate(),
+		grey.getFlickerMargin(), MAXGFX_FLICKER_HZ);
+	printf("%.1f bytes per subframe, rows written %u, rows skipped %u\n",
+		(double)driver.getBytesWritten() / driver.getFrames(), gfx.getRowsWritten(), gfx.getRowsSkipped());
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+// particles.cpp
+//
+// Host example: snow falling on an 8x2 chain with a burst of sparks every 40 steps, printing a few frames and the
+// pool and bus figures
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/particles.cpp -o particles && ./particles
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Particles.h"
+
+int main()
+{
+	MAXDriver_Sim driver;
+	MAXgfx_Chain<8, 2> gfx(driver);
+	MAXParticles<96> snow;
+	MAXParticles<64> sparks;
+
+	//snow spawns just above the display and drifts down at 1/4 to 1/2 pixel per step, sparks may rise above the
+	//top before falling back under gravity
+	snow.setBounds(gfx.getDisplayWidth(), gfx.getDisplayHeight() + 2, 0, -2);
+	sparks.setBounds(gfx.getDisplayWidth(), gfx.getDisplayHeight() + 8, 0, -8);
+	sparks.setGravity(0, 1);
+
+	gfx.init();
+	gfx.addLayer(snow);
+	gfx.addLayer(sparks);
+	driver.resetCounters();
+
+	uint16_t max_count = 0;
+	for (uint16_t step = 0; step < 400; step++)
+	{
+		snow.emit(rand() % gfx.getDisplayWidth(), -2, (rand() % 3) - 1, 4 + rand() % 5);
+		if (step % 40 == 0)
+			sparks.emitBurst(16 + rand() % 32, 10, 24, 0, -8, 10, 8, 30, 10);
+
+		snow.update();
+		sparks.update();
+		gfx.updateDisplay();
+
+		if (snow.getCount() + sparks.getCount() > max_count)
+			max_count = snow.getCount() + sparks.getCount();
+
+		if (step == 120 || step == 121)
+		{
+			printf("step %u: %u snow, %u sparks\n", step, snow.getCount(), sparks.getCount());
+			driver.print(stdout, gfx.getModuleCols());
+		}
+	}
+
+	printf("peak %u particles, %u bytes (%.1f per frame), rows written %u skipped %u\n",
+		max_count, driver.getBytesWritten(), driver.getBytesWritten() / 400.0, gfx.getRowsWritten(), gfx.getRowsSkipped());
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+// scheduled_display.cpp
+//
+// Host example: run a 4x1 chain from MAXScheduler with a simulated clock and an uneven loop,
+// animations at different rates and row writes spread over ticks, then report frame statistics
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/scheduled_display.cpp -o scheduled_display && ./scheduled_display
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Scheduler.h"
+
+namespace
+{
+	//4 frame spinner, frames stored back to back
+	const uint8_t Spinner[4 * MATRIX_DIM] =
+	{
+		0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00,
+		0x02, 0x04, 0x08, 0x10, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00,
+		0x80, 0x40, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00,
+	};
+
+	const uint8_t Ball[MATRIX_DIM] = { 0x60, 0xF0, 0xF0, 0x60 };
+
+	void move_ball(void* context)
+	{
+		MAXSprite* ball = (MAXSprite*)context;
+		ball->move(1, 0);
+		if (ball->getPositionX() >= 32)
+			ball->setPosition(-4, ball->getPositionY());
+	}
+}
+
+int main()
+{
+	MAXDriver_Sim driver;
+	MAXgfx_Chain<4, 1> gfx(driver);
+	MAXScheduler<2> scheduler(gfx);
+
+	MAXSprite_MultiFrame fast(Spinner, 4, 5, 4, false, 2, 2);
+	MAXSprite_MultiFrame slow(Spinner, 4, 5, 4, false, 26, 2);
+	MAXSprite ball(Ball, 4, 4, 0, 0);
+
+	gfx.init();
+	gfx.addLayer(fast);
+	gfx.addLayer(slow);
+	gfx.addLayer(ball);
+
+	//50 frames per second, spinners at 10 and 2 frames per second, two rows per tick
+	scheduler.setFrameRate(50);
+	scheduler.addAnimation(fast, 100000);
+	scheduler.addAnimation(slow, 500000);
+	scheduler.setUpdateCallback(move_ball, &ball);
+	scheduler.setRowsPerTick(2);
+
+	//5 seconds of a loop taking 3 - 9ms per iteration, with a 70ms stall every second
+	uint32_t now = 0;
+	uint32_t max_tick_bytes = 0;
+	for (uint32_t i = 0; now < 5000000; i++)
+	{
+		uint32_t bytes = driver.getBytesWritten();
+		scheduler.tick(now);
+		if (driver.getBytesWritten() - bytes > max_tick_bytes)
+			max_tick_bytes = driver.getBytesWritten() - bytes;
+
+		now += 3000 + (i * 7919) % 6000;
+		if (i % 170 == 169)
+			now += 70000;
+	}
+
+	driver.print(stdout, gfx.getModuleCols());
+
+	printf("%u steps, %u frames, %u dropped, jitter avg %u us max %u us\n",
+		scheduler.getSteps(), scheduler.getFrames(), scheduler.getDroppedFrames(), scheduler.getAverageJitterUs(), scheduler.getMaxJitterUs());
+	printf("max %u bytes (%.2f us) on bus per tick, %u per frame, rows written %u, rows skipped %u\n",
+		max_tick_bytes, max_tick_bytes * 8 / 10.0, driver.getMaxFrameBytes(), gfx.getRowsWritten(), gfx.getRowsSkipped());
+
+	return 0;
+}
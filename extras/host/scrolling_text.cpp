@@ -0,0 +1,38 @@
+// scrolling_text.cpp
+//
+// Host example: scroll text across a 4x1 module chain with a marquee layer and print the display
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/scrolling_text.cpp -o scrolling_text && ./scrolling_text
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Font.h"
+
+int main()
+{
+	MAXDriver_Sim driver;
+	MAXgfx_Chain<4, 1> gfx(driver);
+	MAXMarquee<32> marquee("Hello, MAX72XX!");
+
+	gfx.init();
+	gfx.addLayer(marquee);
+
+	for (uint8_t frame = 0; frame < 48; frame++)
+	{
+		marquee.step();
+		gfx.updateDisplay();
+
+		if (frame % 16 == 15)
+		{
+			driver.print(stdout, gfx.getModuleCols());
+			printf("\n");
+		}
+	}
+
+	printf("%u frames, %u bytes, rows written %u, rows skipped %u\n",
+		driver.getFrames(), driver.getBytesWritten(), gfx.getRowsWritten(), gfx.getRowsSkipped());
+
+	return 0;
+}
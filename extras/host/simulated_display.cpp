@@ -0,0 +1,53 @@
+// simulated_display.cpp
+//
+// Host example: drive a 4x1 module chain through MAXDriver_Sim and report bus cost per frame
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/simulated_display.cpp -o simulated_display && ./simulated_display
+// add -DMAXGFX_PROFILE=1 for a breakdown of where frame time went
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Profile.h"
+
+namespace
+{
+	const uint8_t Ball[MATRIX_DIM] = { 0x60, 0xF0, 0xF0, 0x60 };
+}
+
+int main()
+{
+	//10MHz SPI, 200ns LOAD pulse
+	MAXDriver_Sim driver(10000000, 200);
+	MAXgfx_Chain<4, 1> gfx(driver);
+
+	MAXSprite ball(Ball, 4, 4, 0, 2);
+	MAXSprite_Rectangle border(8, 8, 1, false, 12, 0);
+
+	gfx.init();
+	gfx.addSprite(ball);
+	gfx.addSprite(border);
+	MAXProfile::reset();
+
+	for (uint8_t frame = 0; frame < 29; frame++)
+	{
+		gfx.updateDisplay();
+		printf("frame %2u: %3u bytes, %6.2f us on bus\n", frame, driver.getLastFrameBytes(), driver.getLastFrameNs() / 1000.0);
+		ball.move(1, 0);
+	}
+
+	driver.print(stdout, gfx.getModuleCols());
+
+	printf("%u frames, %u bytes, %u LOAD cycles, rows written %u, rows skipped %u\n",
+		driver.getFrames(), driver.getBytesWritten(), driver.getTransactions(), gfx.getRowsWritten(), gfx.getRowsSkipped());
+
+	if (MAXProfile::isEnabled())
+	{
+		MAXProfileStats stats;
+		MAXProfile::snapshot(stats);
+		MAXProfile::print(stdout, stats);
+	}
+
+	return 0;
+}
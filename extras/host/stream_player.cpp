@@ -0,0 +1,113 @@
+// stream_player.cpp
+//
+// Host example: render a bouncing ball, send it as a MAXStream packet stream through a file (one packet corrupted
+// on the way), then play the file back on a simulated 4x1 chain with both drop policies
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/stream_player.cpp -o stream_player && ./stream_player
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Stream.h"
+
+namespace
+{
+	const uint16_t WIDTH = 32;
+	const uint16_t HEIGHT = 8;
+	const uint16_t FRAMES = 200;
+	const uint8_t KEY_INTERVAL = 25;
+
+	//sender side: ball frames as packets
+	void write_stream(FILE* file)
+	{
+		uint8_t frames[2][MAXBitmap::getBufferSize(WIDTH, HEIGHT)] = {};
+		uint8_t packet[128];
+		int x = 3, y = 3, dx = 1, dy = 1;
+
+		for (uint16_t i = 0; i < FRAMES; i++)
+		{
+			uint8_t* frame = frames[i & 1];
+			uint8_t* previous = frames[(i + 1) & 1];
+
+			MAXBitmap bitmap(frame, WIDTH, HEIGHT);
+			bitmap.clear();
+			bitmap.fillCircle(x, y, 2);
+
+			//moves every other frame
+			if (i & 1)
+			{
+				if (x + dx < 2 || x + dx > WIDTH - 3) dx = -dx;
+				if (y + dy < 2 || y + dy > HEIGHT - 3) dy = -dy;
+				x += dx;
+				y += dy;
+			}
+
+			uint16_t size = MAXStream::encodeFrame(frame, i ? previous : NULL, bitmap.getStride(), HEIGHT, (uint8_t)i, i % KEY_INTERVAL == 0, packet, sizeof(packet));
+
+			//line noise
+			if (i == 60)
+				packet[size / 2] ^= 0x10;
+
+			fwrite(packet, 1, size, file);
+		}
+	}
+
+	void play(FILE* file, uint8_t policy, const char* name)
+	{
+		MAXDriver_Sim driver;
+		MAXgfx_Chain<4, 1> gfx(driver);
+		MAXStreamPlayer<WIDTH, HEIGHT, 128> player;
+
+		gfx.init();
+		gfx.addLayer(player);
+		player.setPolicy(policy);
+		rewind(file);
+
+		//link delivers 48 bytes (2 - 4 frames) per display frame: the player either holds it back or drops frames
+		uint8_t chunk[24];
+		uint16_t chunk_size = 0, chunk_used = 0;
+		uint32_t display_frames = 0;
+
+		while (true)
+		{
+			for (uint8_t reads = 0; reads < 2; reads++)
+			{
+				if (chunk_used == chunk_size)
+				{
+					chunk_size = fread(chunk, 1, sizeof(chunk), file);
+					chunk_used = 0;
+				}
+				chunk_used += player.write(chunk + chunk_used, chunk_size - chunk_used);
+			}
+
+			player.update();
+			gfx.updateDisplay();
+			display_frames++;
+
+			if (!chunk_size && !player.getUsed())
+				break;
+		}
+
+		driver.print(stdout, gfx.getModuleCols());
+		printf("%s: %u display frames, %u bytes in, frames received %u shown %u dropped %u, bad packets %u, discarded %u bytes, stalls %u, ring max %u/%u\n",
+			name, display_frames, player.getBytesReceived(), player.getFramesReceived(), player.getFramesShown(), player.getFramesDropped(),
+			player.getBadPackets(), player.getBytesDiscarded(), player.getStalls(), player.getMaxUsed(), player.getRingSize());
+	}
+}
+
+int main()
+{
+	FILE* file = tmpfile();
+	if (!file)
+		return 1;
+
+	write_stream(file);
+	printf("%u frames, %ld bytes (%u raw)\n\n", FRAMES, ftell(file), FRAMES * MAXBitmap::getBufferSize(WIDTH, HEIGHT));
+
+	play(file, MAXStreamPlayer_Base::StreamBackpressure, "backpressure");
+	play(file, MAXStreamPlayer_Base::StreamLatest, "latest");
+
+	fclose(file);
+	return 0;
+}
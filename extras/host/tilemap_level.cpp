@@ -0,0 +1,73 @@
+// tilemap_level.cpp
+//
+// Host example: side scrolling level built from 8x8 tiles (map and tile set in flash) on a 4x1 chain, the view moving
+// one pixel a frame and wrapping at the end of the level, with a sprite standing on whatever tile is below it
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/host/tilemap_level.cpp -o tilemap_level && ./tilemap_level
+
+#include <stdio.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Tilemap.h"
+
+namespace
+{
+	enum enumTiles : uint8_t { Sky, Ground, Brick, Pipe, Coin };
+
+	const uint8_t Tiles[] PROGMEM =
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,		//sky
+		0xFF, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55,		//ground
+		0xFF, 0x81, 0x81, 0xFF, 0x18, 0x18, 0x18, 0xFF,		//brick
+		0x7E, 0x7E, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C,		//pipe
+		0x00, 0x18, 0x3C, 0x3C, 0x3C, 0x18, 0x00, 0x00,		//coin
+	};
+
+	//16 x 2 tiles, 128 x 16 pixels: upper row is the playing area, lower row the ground
+	const uint8_t Level[] PROGMEM =
+	{
+		Sky, Coin, Sky, Sky, Brick, Sky, Sky, Pipe, Sky, Coin, Coin, Sky, Brick, Brick, Sky, Pipe,
+		Ground, Ground, Ground, Ground, Ground, Sky, Ground, Ground, Ground, Ground, Ground, Ground, Sky, Ground, Ground, Ground,
+	};
+
+	const uint8_t Player[MATRIX_DIM] = { 0x60, 0x60, 0xF0, 0x60, 0x90 };
+}
+
+int main()
+{
+	MAXDriver_Sim driver;
+	MAXgfx_Chain<4, 1> gfx(driver);
+	MAXTilemap level(Tiles, sizeof(Tiles) / MATRIX_DIM, Level, 16, 2, true);
+	MAXSprite player(Player, 4, 5, 6, -1);
+
+	//8 pixel high display shows the bottom of the playing area and the top of the ground
+	level.setWrap(true, false);
+	level.setView(0, 4);
+
+	gfx.init();
+	gfx.addLayer(level);
+	gfx.addLayer(player, BlendXor);
+	driver.resetCounters();
+
+	uint16_t frames = 2 * level.getMapWidth();
+	uint16_t falling = 0;
+	for (uint16_t frame = 0; frame < frames; frame++)
+	{
+		level.moveView(1, 0);
+
+		//player is over a gap when there's no ground tile under its feet
+		if (level.getTileAt(level.getViewX() + player.getPositionX() + 1, 8) != Ground)
+			falling++;
+
+		gfx.updateDisplay();
+
+		if (frame == 20 || frame == 21)
+			driver.print(stdout, gfx.getModuleCols());
+	}
+
+	printf("%u frames, %u over a gap, %u bytes (%.1f per frame), rows written %u skipped %u\n",
+		frames, falling, driver.getBytesWritten(), driver.getBytesWritten() / (double)frames, gfx.getRowsWritten(), gfx.getRowsSkipped());
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+// delta_encode.cpp
+//
+// Offline encoder: raw animation frames (MATRIX_DIM bytes per frame, back to back, MSB = left pixel) to a MAXDelta
+// array in flash, for MAXSprite_Delta.
+//
+// build and run from the library root:
+//   g++ -O2 -std=c++11 -I. MAXgfx*.cpp extras/tools/delta_encode.cpp -o delta_encode
+//   ./delta_encode walk 16 < walk.bin > walk.h
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAXgfx.h"
+#include "MAXgfx_Delta.h"
+
+namespace
+{
+	const uint16_t MAX_FRAMES = 0xFFFF;
+	const uint16_t MAX_SIZE = 0xFFFF;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s name [key interval 1-255, default 16] < frames.bin > name.h\n", argv[0]);
+		return 1;
+	}
+
+	const char* name = argv[1];
+	int key_interval = argc > 2 ? atoi(argv[2]) : 16;
+	if (key_interval < 1 || key_interval > 255)
+	{
+		fprintf(stderr, "key interval must be 1 - 255\n");
+		return 1;
+	}
+
+	//whole frames only
+	static uint8_t frames[(uint32_t)MAX_FRAMES * MATRIX_DIM];
+	size_t frame_count = fread(frames, MATRIX_DIM, MAX_FRAMES, stdin);
+	if (!frame_count)
+	{
+		fprintf(stderr, "no frames read\n");
+		return 1;
+	}
+
+	static uint8_t output[MAX_SIZE];
+	uint16_t size = MAXDelta::encode(frames, (uint16_t)frame_count, (uint8_t)key_interval, output, MAX_SIZE);
+	if (!size)
+	{
+		fprintf(stderr, "encoded animation doesn't fit in 64KB, split it or raise the key interval\n");
+		return 1;
+	}
+
+	printf("// %s: %u frames, key interval %d, %u bytes (%u raw)\n\n", name, (unsigned)frame_count, key_interval, size, (unsigned)(frame_count * MATRIX_DIM));
+	printf("const uint8_t %s[] PROGMEM =\n{", name);
+	for (uint16_t i = 0; i < size; i++)
+		printf("%s0x%02X,", i % 16 ? " " : "\n\t", output[i]);
+	printf("\n};\n");
+
+	fprintf(stderr, "%s: %u frames -> %u bytes\n", name, (unsigned)frame_count, size);
+	return 0;
+}